@@ -0,0 +1,106 @@
+#pragma once
+#include <stdint.h>
+
+// Stall-margin search (MotionController::startAutoTune()). Stage 0 runs the current
+// maxSps/accel; each later stage scales both by (100 + stepPercent)%. A stage passes after
+// hitsPerStage end hits whose switch point stays within lostStepLimit of the learned
+// travel. The first stage that loses steps (or faults) ends the search, and the last
+// passing stage minus marginPercent becomes the config.
+struct MotionAutoTunePolicy {
+    uint8_t stepPercent = 10;
+    uint8_t hitsPerStage = 6;        // 3 full cycles
+    uint8_t marginPercent = 20;
+    uint8_t maxStages = 12;
+    uint32_t lostStepLimit = 32;     // fine steps (2 full steps at 1/16)
+    float spsCeiling = 8000.0f;      // never probe above this (capped at MOTION_SPS_EDIT_MAX)
+};
+
+enum class AutoTuneResult : uint8_t {
+    None = 0,
+    Ceiling = 1,     // every stage up to the ceiling/maxStages passed
+    LostSteps = 2,   // a stage missed the switch point by more than lostStepLimit
+    Fault = 3,       // a stage faulted (stall, position window, timeout)
+    Aborted = 4      // stopped by request; config restored
+};
+
+// The search bookkeeping without the motion side (no Arduino, host-tested in test/native):
+// MotionController applies stageSps/stageAccel, publishes status and raises the event.
+struct AutoTuneSearch {
+    enum class Hit : uint8_t {
+        Counted = 0,     // clean, stage still running
+        NextStage = 1,   // stage passed, stageSps/stageAccel now hold the next one
+        Ceiling = 2,     // stage passed and it was the last: finish(Ceiling)
+        LostSteps = 3    // finish(LostSteps)
+    };
+
+    bool running = false;
+    MotionAutoTunePolicy policy;
+    float baseSps = 0;       // config before the search (restored on abort)
+    float baseAccel = 0;
+    float stageSps = 0;      // stage being run
+    float stageAccel = 0;
+    float passSps = 0;       // last stage that passed (0 = none yet)
+    float passAccel = 0;
+    uint8_t stage = 0;
+    uint8_t hits = 0;        // clean end hits in this stage
+    uint8_t passed = 0;      // stages passed
+
+    // spsMax: the fastest speed the backend/editor can hold (spsCeiling is capped to it)
+    void begin(const MotionAutoTunePolicy& p, float sps, float accel, float spsMax) {
+        policy = p;
+        if (policy.stepPercent == 0) policy.stepPercent = 10;
+        if (policy.hitsPerStage < 2) policy.hitsPerStage = 2;
+        if (policy.marginPercent > 90) policy.marginPercent = 90;
+        if (policy.maxStages == 0) policy.maxStages = 1;
+        // never probe (and commit) a speed the backend can't hold or the editor can't show
+        if (!(policy.spsCeiling > 0.0f) || policy.spsCeiling > spsMax) policy.spsCeiling = spsMax;
+
+        running = true;
+        baseSps = stageSps = sps;
+        baseAccel = stageAccel = accel;
+        passSps = 0;
+        passAccel = 0;
+        stage = 0;
+        hits = 0;
+        passed = 0;
+    }
+
+    // Judge one end hit of the running stage (err = switch point - expected).
+    Hit endHit(long err) {
+        const uint32_t mag = (uint32_t)((err < 0) ? -err : err);
+        if (mag > policy.lostStepLimit) return Hit::LostSteps;
+        if (++hits < policy.hitsPerStage) return Hit::Counted;
+
+        // stage clean: remember it and go one step more aggressive
+        passSps = stageSps;
+        passAccel = stageAccel;
+        passed++;
+
+        const float k = (100.0f + policy.stepPercent) / 100.0f;
+        if (stage + 1 >= policy.maxStages || stageSps * k > policy.spsCeiling) return Hit::Ceiling;
+        stage++;
+        hits = 0;
+        stageSps *= k;
+        stageAccel *= k;
+        return Hit::NextStage;
+    }
+
+    // Ends the search; sps/accel get the config to keep: the base on Aborted, otherwise the
+    // last passing stage minus marginPercent, in whole numbers so the reported values are
+    // exactly what gets persisted.
+    void finish(AutoTuneResult result, float minSps, float& sps, float& accel) {
+        running = false;
+        sps = baseSps;
+        accel = baseAccel;
+        if (result == AutoTuneResult::Aborted) return;
+
+        // no clean stage at all: the current config itself lost steps, derate it too
+        const float keep = (100.0f - policy.marginPercent) / 100.0f;
+        sps = ((passSps > 0) ? passSps : baseSps) * keep;
+        accel = ((passAccel > 0) ? passAccel : baseAccel) * keep;
+        if (sps < minSps) sps = minSps;
+        sps = (float)(uint32_t)sps;
+        accel = (float)(uint32_t)accel;
+        if (accel < 1.0f) accel = 1.0f;
+    }
+};
@@ -16,6 +16,7 @@ void EncoderController::begin(const EncoderConfig& cfg_) {
     logic.begin(cfg_, initialAB, initialBtn);
 
     hal.attachABInterrupts(isrRouter);
+    hal.attachBtnInterrupt(btnWakeIsr);
 }
 
 EncoderEvents EncoderController::poll() {
@@ -8,9 +8,12 @@ public:
 
     void begin(const EncoderConfig& cfg_);
     EncoderEvents poll();
+    // See EncoderLogic::msUntilNextPoll(). A/B and button edges wake the loop by IRQ.
+    uint32_t msUntilNextPoll() const { return logic.msUntilNextPoll(hal.millisNow()); }
 
 private:
     static void isrRouter();
+    static void btnWakeIsr() {}   // the IRQ itself ends a WFE idle; poll() reads the level
     void handleIsr();
     uint8_t readAB() const;
 
@@ -109,4 +109,20 @@ EncoderEvents EncoderLogic::poll(uint32_t nowMs, int btnRaw) {
     }
 
     return e;
-}
\ No newline at end of file
+}
+
+uint32_t EncoderLogic::msUntilNextPoll(uint32_t nowMs) const {
+    if (pendingDelta != 0 || isrDeltaAccum != 0) return 0;
+
+    uint32_t wait = UINT32_MAX;
+    if (btnRawPrev != btnStable) {
+        const uint32_t since = nowMs - btnRawChangeMs;
+        wait = (since >= cfg.btnDebounceMs) ? 0 : cfg.btnDebounceMs - since;
+    }
+    if (pressed && !veryLongFired) {
+        const uint32_t held = nowMs - pressStartMs;
+        const uint32_t left = (held >= cfg.veryLongPressMs) ? 0 : cfg.veryLongPressMs - held;
+        if (left < wait) wait = left;
+    }
+    return wait;
+}
@@ -18,6 +18,10 @@ public:
     // loop에서 호출
     EncoderEvents poll(uint32_t nowMs, int btnRaw);
 
+    // ms until poll() must run again without a new edge (0 = now, UINT32_MAX = only on an edge):
+    // queued detents, a debounce in progress, or a held button heading for very-long.
+    uint32_t msUntilNextPoll(uint32_t nowMs) const;
+
 private:
     EncoderConfig cfg;
 
@@ -1,33 +1,77 @@
 #include "MotionController.h"
 
-// ---- static helpers ----
-float MotionController::maxf(float a, float b) { return a > b ? a : b; }
+using namespace motion_math;
 
 // ---- UI mute ----
 void MotionController::setUiMuteSeconds(uint16_t seconds) {
-    uiMuteUntilMs = millis() + (uint32_t)seconds * 1000UL;
+    MotionCommand c; c.type = MotionCommand::Type::UiMute; c.u0 = seconds;
+    enqueue(c);
 }
 bool MotionController::isUiMuteActive() const {
     return (uiMuteUntilMs != 0) && ((int32_t)(millis() - uiMuteUntilMs) < 0);
 }
 
 // ---- lifecycle ----
+void MotionController::setChannel(uint8_t index, const MotionPins& p) {
+    channelIdx = index;
+    pins = p;
+#if MOTION_STEPPER_SIO && MOTION_CHANNELS == 1
+    // single channel: drv is StepperHal_Sio<DefaultStepperPins>, the same pins as kMotionPins[0]
+#elif MOTION_STEPPER_SIO
+    drv = StepperHal_Sio<MotionPins>(p);
+#else
+    drv = StepperHal_Drv8825(p);
+#endif
+    msWired = (p.ms1 != 255 && p.ms2 != 255 && p.ms3 != 255);
+    ustep.enabled = msWired;
+}
+
+void MotionController::attachStepGenerator(StepGenHal* gen) { stepGen = gen; }
+
 void MotionController::begin(const MotionConfig& cfg_) {
     cfg = cfg_;
+    applyFixedConfig();
 
-    pinMode(PIN_HALL_LEFT, INPUT_PULLDOWN);
-    pinMode(PIN_HALL_RIGHT, INPUT_PULLDOWN);
+    pinMode(pins.hallLeft, INPUT_PULLDOWN);
+    pinMode(pins.hallRight, INPUT_PULLDOWN);
 
-    pinMode(PIN_GROW_LED, OUTPUT);
-    digitalWrite(PIN_GROW_LED, LOW);
+    if (pins.growLed != 255) {
+        pinMode(pins.growLed, OUTPUT);
+        digitalWrite(pins.growLed, LOW);
+    }
 
     drv.begin();
     drv.enable(false); // LED policy decides
+    applyUstepShift(0);
+
+    // STEP pin is handed over to the generator (fall back to polled if it can't start).
+    if (stepGen && !stepGen->begin()) stepGen = nullptr;
+
+#if MOTION_HALL_IRQ
+    // Attached from the core that runs tick(), so the ISR never races it across cores.
+    resyncHallInputs();
+    attachInterruptParam(digitalPinToInterrupt(pins.hallLeft), hallIsrLeft, CHANGE, this);
+    attachInterruptParam(digitalPinToInterrupt(pins.hallRight), hallIsrRight, CHANGE, this);
+#endif
+
+    startFromRest(true);
 
-    resetForHoming(true);
+#if MOTION_ON_CORE1
+    cfgChanged = true;
+    lastFullPublishUs = micros() - kFullPublishUs;
+    publishStatus(micros());
+#endif
 }
 
 // ---- persist restore ----
+void MotionController::applyPersistedMotion(uint32_t travelSteps, long parkPos, bool parkValid,
+                                            uint8_t microstepDiv) {
+    if (travelSteps == 0 || microstepDiv != fineMicrostepDiv()) return;   // other step unit: recalibrate
+    st.travelSteps = travelSteps;
+    st.pos = parkValid ? parkPos : 0;
+    st.posValid = parkValid;
+}
+
 void MotionController::applyPersistedAlerts(uint32_t seq, uint8_t head, uint8_t count,
                                             const uint8_t* codes, const uint32_t* uptimeSec) {
     alerts.seq = seq;
@@ -75,6 +119,13 @@ void MotionController::applyPersistedFactory(uint32_t seq, bool lastPass, uint8_
 // ---- factory result record ----
 void MotionController::recordFactoryResult(bool pass, uint8_t failCode, uint8_t failStep,
                                            uint32_t durationMs, uint32_t uptimeMs) {
+    MotionCommand c; c.type = MotionCommand::Type::FactoryResult;
+    c.b0 = pass ? 1 : 0; c.b1 = failCode; c.b2 = failStep; c.u0 = durationMs; c.u1 = uptimeMs;
+    enqueue(c);
+}
+
+void MotionController::recordFactoryResultNow(bool pass, uint8_t failCode, uint8_t failStep,
+                                              uint32_t durationMs, uint32_t uptimeMs) {
     factory.seq++;
     factory.lastPass = pass;
     factory.failCode = failCode;
@@ -86,9 +137,11 @@ void MotionController::recordFactoryResult(bool pass, uint8_t failCode, uint8_t
 
     pushFactoryLog(pass, failCode, failStep, durationMs, uptimeMs, st.cycles);
 
-    if (factory.cb) {
-        factory.cb(factory.seq, pass, failCode, failStep, durationMs, uptimeMs, st.cycles);
-    }
+    MotionEvent e;
+    e.type = MotionEvent::Type::Factory;
+    e.seq = factory.seq; e.pass = pass; e.code = failCode; e.failStep = failStep;
+    e.durationMs = durationMs; e.uptimeMs = uptimeMs; e.cycles = st.cycles;
+    evtQ.push(e);
 
     syncFactoryStatus();
 }
@@ -96,74 +149,482 @@ void MotionController::recordFactoryResult(bool pass, uint8_t failCode, uint8_t
 // ---- callbacks ----
 void MotionController::setAlertCallback(AlertCallback cb) { alerts.cb = cb; }
 void MotionController::setFactoryCallback(FactoryCallback cb) { factory.cb = cb; }
+void MotionController::setAutoTuneCallback(AutoTuneCallback cb) { tune.cb = cb; }
 
 // ---- alert ack ----
 void MotionController::acknowledgeAlert(uint32_t seq) {
-    if (alerts.seq == seq) {
-        alerts.pending = false;
-        alerts.pendingCode = 0;
-        syncAlertStatus();
-    }
+    MotionCommand c; c.type = MotionCommand::Type::AckAlert; c.u0 = seq;
+    enqueue(c);
 }
 
 // ---- config ----
-void MotionController::applyConfig(const MotionConfig& cfg_) { cfg = cfg_; }
+void MotionController::applyConfig(const MotionConfig& cfg_) { cfg = cfg_; applyFixedConfig(); }
+#if MOTION_ON_CORE1
+const MotionConfig& MotionController::config() const { return view.cfg; }
+const MotionStatus& MotionController::status() const { return view.st; }
+void MotionController::copyStatus(MotionStatus& out) const { stPub.read(out); }
+MotionHotStatus MotionController::hotStatus() const {
+    MotionHotStatus h;
+    hotPub.read(h);
+    return h;
+}
+#else
 const MotionConfig& MotionController::config() const { return cfg; }
 const MotionStatus& MotionController::status() const { return st; }
+void MotionController::copyStatus(MotionStatus& out) const { out = st; }
+MotionHotStatus MotionController::hotStatus() const { return makeHot(st); }
+#endif
+
+MotionHotStatus MotionController::makeHot(const MotionStatus& s) {
+    MotionHotStatus h;
+    h.state = s.state;
+    h.err = s.err;
+    h.hallL = s.hallL;
+    h.hallR = s.hallR;
+    h.ledOn = s.ledOn;
+    h.currentSps = s.currentSps;
+    h.pos = s.pos;
+    h.travelSteps = s.travelSteps;
+    h.cycles = s.cycles;
+    return h;
+}
 
 // ---- LED API ----
-void MotionController::setLedModeAuto() { led.mode = LedMode::Auto; }
-void MotionController::setLedModeManual(bool on) { led.mode = LedMode::Manual; led.manualOn = on; }
+void MotionController::setLedModeAuto() {
+    MotionCommand c; c.type = MotionCommand::Type::LedAuto;
+    enqueue(c);
+}
+void MotionController::setLedModeManual(bool on) {
+    MotionCommand c; c.type = MotionCommand::Type::LedManual; c.b0 = on ? 1 : 0;
+    enqueue(c);
+}
 void MotionController::setLedScheduleMinutes(uint16_t onStartMin, uint16_t onEndMin) {
-    led.onStartMin = onStartMin;
-    led.onEndMin = onEndMin;
+    MotionCommand c; c.type = MotionCommand::Type::LedSchedule; c.u0 = onStartMin; c.u1 = onEndMin;
+    enqueue(c);
 }
 void MotionController::setClockMinutes(uint16_t minutesSinceMidnight) {
-    led.clockValid = true;
-    led.clockMin = minutesSinceMidnight % 1440;
+    MotionCommand c; c.type = MotionCommand::Type::Clock; c.u0 = minutesSinceMidnight;
+    enqueue(c);
+}
+
+// ---- step timing ----
+void MotionController::resetStepTimingStats() {
+    MotionCommand c; c.type = MotionCommand::Type::ResetStepTiming;
+    enqueue(c);
 }
 
 // ---- safety API ----
-void MotionController::setMotionStallPulseTimeoutMs(uint32_t ms) { safety.pulseStallTimeoutMs = ms; }
-void MotionController::setMotionStallNoEndTimeoutMs(uint32_t ms) { safety.noEndTimeoutMs = ms; }
+void MotionController::setMotionStallPulseTimeoutMs(uint32_t ms) {
+    MotionCommand c; c.type = MotionCommand::Type::StallPulseTimeout; c.u0 = ms;
+    enqueue(c);
+}
+void MotionController::setMotionStallNoEndTimeoutMs(uint32_t ms) {
+    MotionCommand c; c.type = MotionCommand::Type::StallNoEndTimeout; c.u0 = ms;
+    enqueue(c);
+}
+void MotionController::setStepCatchUp(bool enabled, uint8_t maxBurstSteps, uint16_t capPercent) {
+    MotionCommand c; c.type = MotionCommand::Type::StepCatchUp;
+    c.b0 = enabled ? 1 : 0; c.b1 = maxBurstSteps; c.u0 = capPercent;
+    enqueue(c);
+}
+
+void MotionController::setMicrostepPolicy(bool enabled, uint8_t fineDiv, uint8_t coarseDiv,
+                                          uint32_t coarseAboveSps, uint32_t fineBelowSps) {
+    MotionCommand c; c.type = MotionCommand::Type::StepMicrostep;
+    c.b0 = enabled ? 1 : 0; c.b1 = fineDiv; c.b2 = coarseDiv;
+    c.u0 = coarseAboveSps; c.u1 = fineBelowSps;
+    enqueue(c);
+}
+
+void MotionController::setDriftCompensation(bool enabled, uint32_t rehomeAboveSteps) {
+    MotionCommand c; c.type = MotionCommand::Type::DriftComp;
+    c.b0 = enabled ? 1 : 0; c.u0 = rehomeAboveSteps;
+    enqueue(c);
+}
+
+void MotionController::setPositionWindow(bool enabled, uint32_t warnSteps, uint32_t faultSteps) {
+    MotionCommand c; c.type = MotionCommand::Type::PosWindow;
+    c.b0 = enabled ? 1 : 0; c.u0 = warnSteps; c.u1 = faultSteps;
+    enqueue(c);
+}
+
+void MotionController::setHomingPolicy(bool twoStage, uint16_t blindSeekPercent, uint32_t backoffSteps) {
+    MotionCommand c; c.type = MotionCommand::Type::HomingMode;
+    c.b0 = twoStage ? 1 : 0; c.u0 = blindSeekPercent; c.u1 = backoffSteps;
+    enqueue(c);
+}
+
+void MotionController::setHallGlitchFilterUs(uint32_t us) {
+    MotionCommand c; c.type = MotionCommand::Type::HallGlitch; c.u0 = us;
+    enqueue(c);
+}
 
 // ---- request API ----
-void MotionController::requestStart() { pending.start = true; }
-void MotionController::requestStop() { pending.stop = true; }
-void MotionController::requestHome() { pending.home = true; }
-void MotionController::requestRecalibrate() { pending.recalibrate = true; }
-void MotionController::requestForceMoveLeft() { pending.forceMoveLeft = true; }
-void MotionController::requestForceMoveRight() { pending.forceMoveRight = true; }
-void MotionController::requestDisableMotor() { pending.stop = true; }
-void MotionController::requestInjectFault(MotionError e) { pending.injectFault = true; pending.faultToInject = e; }
-void MotionController::requestSetMaxSps(float sps) { pending.setMaxSps = true; pending.maxSps = sps; }
-void MotionController::requestSetAccel(float a) { pending.setAccel = true; pending.accel = a; }
-void MotionController::requestSetDwell(uint32_t ms) { pending.setDwell = true; pending.dwellMs = ms; }
-void MotionController::requestSetRehomeEvery(uint32_t cycles) { pending.setRehome = true; pending.rehomeEvery = cycles; }
+static MotionCommand makeCmd(MotionCommand::Type t) { MotionCommand c; c.type = t; return c; }
+
+void MotionController::requestStart() { enqueue(makeCmd(MotionCommand::Type::Start)); }
+void MotionController::requestStop() { enqueue(makeCmd(MotionCommand::Type::Stop)); }
+void MotionController::requestHome() { enqueue(makeCmd(MotionCommand::Type::Home)); }
+void MotionController::requestRecalibrate() { enqueue(makeCmd(MotionCommand::Type::Recalibrate)); }
+void MotionController::requestForceMoveLeft() { enqueue(makeCmd(MotionCommand::Type::ForceMoveLeft)); }
+void MotionController::requestForceMoveRight() { enqueue(makeCmd(MotionCommand::Type::ForceMoveRight)); }
+void MotionController::requestDisableMotor() { enqueue(makeCmd(MotionCommand::Type::Stop)); }
+void MotionController::requestInjectFault(MotionError e) {
+    MotionCommand c = makeCmd(MotionCommand::Type::InjectFault); c.b0 = (uint8_t)e; enqueue(c);
+}
+void MotionController::requestSetMaxSps(float sps) {
+    MotionCommand c = makeCmd(MotionCommand::Type::SetMaxSps); c.f = sps; enqueue(c);
+}
+void MotionController::requestSetAccel(float a) {
+    MotionCommand c = makeCmd(MotionCommand::Type::SetAccel); c.f = a; enqueue(c);
+}
+void MotionController::requestSetDwell(uint32_t ms) {
+    MotionCommand c = makeCmd(MotionCommand::Type::SetDwell); c.u0 = ms; enqueue(c);
+}
+void MotionController::requestSetRehomeEvery(uint32_t cycles) {
+    MotionCommand c = makeCmd(MotionCommand::Type::SetRehome); c.u0 = cycles; enqueue(c);
+}
+void MotionController::requestSetProfile(MotionProfile p) {
+    MotionCommand c = makeCmd(MotionCommand::Type::SetProfile); c.b0 = (uint8_t)p; enqueue(c);
+}
+void MotionController::requestSetJerk(float j) {
+    MotionCommand c = makeCmd(MotionCommand::Type::SetJerk); c.f = j; enqueue(c);
+}
+void MotionController::requestSetReversal(ReversalMode m) {
+    MotionCommand c = makeCmd(MotionCommand::Type::SetReversal); c.b0 = (uint8_t)m; enqueue(c);
+}
+void MotionController::requestSetReverseSettle(uint32_t ms) {
+    MotionCommand c = makeCmd(MotionCommand::Type::SetSettle); c.u0 = ms; enqueue(c);
+}
+void MotionController::requestSetZone(uint8_t index, uint16_t fromPermille, uint16_t toPermille, float sps) {
+    MotionCommand c = makeCmd(MotionCommand::Type::SetZone);
+    c.b0 = index; c.u0 = fromPermille; c.u1 = toPermille; c.f = sps;
+    enqueue(c);
+}
+
+// ---- motion program ----
+void MotionController::requestProgramClear() { enqueue(makeCmd(MotionCommand::Type::ProgramClear)); }
+void MotionController::requestProgramMoveTo(long pos, float sps) {
+    MotionCommand c = makeCmd(MotionCommand::Type::ProgramAdd);
+    c.b0 = (uint8_t)MotionProgramStep::Op::MoveTo; c.u0 = (uint32_t)(int32_t)pos; c.f = sps;
+    enqueue(c);
+}
+void MotionController::requestProgramMoveToFraction(uint16_t permille, float sps) {
+    MotionCommand c = makeCmd(MotionCommand::Type::ProgramAdd);
+    c.b0 = (uint8_t)MotionProgramStep::Op::MoveTo; c.b1 = 1; c.u0 = permille; c.f = sps;
+    enqueue(c);
+}
+void MotionController::requestProgramHold(uint32_t ms) {
+    MotionCommand c = makeCmd(MotionCommand::Type::ProgramAdd);
+    c.b0 = (uint8_t)MotionProgramStep::Op::Hold; c.u0 = ms;
+    enqueue(c);
+}
+void MotionController::requestProgramSweep(long a, long b, uint8_t count, bool fraction, float sps) {
+    MotionCommand c = makeCmd(MotionCommand::Type::ProgramAdd);
+    c.b0 = (uint8_t)MotionProgramStep::Op::Sweep; c.b1 = fraction ? 1 : 0; c.b2 = count;
+    c.u0 = (uint32_t)(int32_t)a; c.u1 = (uint32_t)(int32_t)b; c.f = sps;
+    enqueue(c);
+}
+void MotionController::requestProgramRun() { enqueue(makeCmd(MotionCommand::Type::ProgramRun)); }
 
 // ---- simulate hall ----
 void MotionController::requestSimulateHallLeft(uint16_t activeMs) {
-    sim.leftActive = true;
-    sim.leftUntilMs = millis() + activeMs;
+    MotionCommand c = makeCmd(MotionCommand::Type::SimHallLeft); c.u0 = activeMs; enqueue(c);
 }
 void MotionController::requestSimulateHallRight(uint16_t activeMs) {
-    sim.rightActive = true;
-    sim.rightUntilMs = millis() + activeMs;
+    MotionCommand c = makeCmd(MotionCommand::Type::SimHallRight); c.u0 = activeMs; enqueue(c);
+}
+void MotionController::simulateHall(bool left, uint16_t activeMs) {
+    if (left) { sim.leftActive = true;  sim.leftUntilMs = millis() + activeMs; }
+    else      { sim.rightActive = true; sim.rightUntilMs = millis() + activeMs; }
 }
 
+// ---- command / event queues ----
+void MotionController::enqueue(const MotionCommand& c) {
+    if (!cmdQ.push(c)) cmdDropped++;
+}
+
+bool MotionController::applyCommand(const MotionCommand& c) {
+    using T = MotionCommand::Type;
+    switch (c.type) {
+        case T::SetMaxSps:  cfg.maxSps = c.f; applyFixedConfig(); break;
+        case T::SetAccel:   cfg.accel = c.f; applyFixedConfig(); break;
+        case T::SetDwell:   cfg.dwellMs = c.u0; markConfigChanged(); break;
+        case T::SetRehome:  cfg.rehomeEveryCycles = c.u0; markConfigChanged(); break;
+        case T::SetProfile: cfg.profile = (MotionProfile)c.b0; applyFixedConfig(); break;
+        case T::SetJerk:    cfg.jerk = c.f; applyFixedConfig(); break;
+        case T::SetReversal: cfg.reversal = (ReversalMode)c.b0; applyFixedConfig(); break;
+        case T::SetSettle:  cfg.reverseSettleMs = c.u0; markConfigChanged(); break;
+        case T::SetZone:
+            if (c.b0 < kMotionZoneCount) {
+                MotionZone& z = cfg.zones[c.b0];
+                z.fromPermille = (uint16_t)(c.u0 > 1000 ? 1000 : c.u0);
+                z.toPermille = (uint16_t)(c.u1 > 1000 ? 1000 : c.u1);
+                z.sps = c.f;
+                applyFixedConfig();
+            }
+            break;
+
+        case T::Stop:
+            if (isMovingState(st.state) && st.state != MotionState::Stopping) beginControlledStop(millis());
+            else if (st.state != MotionState::Stopping) enterStopped(millis());
+            stopping.restartAfter = false;
+            program.runAfterStop = false;
+            break;
+
+        case T::ProgramAdd:
+            if (program.count >= ProgramQueue::kCapacity) {
+                st.programRejects++;
+                break;
+            }
+            {
+                MotionProgramStep& p = program.steps[(program.head + program.count) % ProgramQueue::kCapacity];
+                p = MotionProgramStep{};
+                p.op = (MotionProgramStep::Op)c.b0;
+                p.fraction = c.b1 != 0;
+                p.count = c.b2;
+                p.a = (long)(int32_t)c.u0;
+                p.b = (long)(int32_t)c.u1;
+                p.sps = (c.f > 0.0f) ? toInt(toQ16(c.f)) : 0;
+                program.count++;
+                st.programQueued = program.count;
+            }
+            break;
+        case T::ProgramClear:
+            program.count = 0;
+            program.leg = 0;
+            program.runAfterStop = false;
+            st.programQueued = 0;
+            if (st.state == MotionState::ProgramMove) beginControlledStop(millis());
+            else if (st.state == MotionState::ProgramHold) enterStopped(millis());
+            break;
+        case T::ProgramRun:
+            if (!startProgram(millis(), micros())) st.programRejects++;
+            break;
+        case T::AutoTuneStart: {
+            MotionAutoTunePolicy p;
+            p.stepPercent = c.b0;
+            p.hitsPerStage = c.b1;
+            p.marginPercent = c.b2;
+            p.lostStepLimit = c.u0;
+            p.maxStages = (uint8_t)c.u1;
+            p.spsCeiling = c.f;
+            startAutoTuneNow(p);
+            break;
+        }
+        case T::AutoTuneStop:
+            if (tune.running) finishAutoTune(AutoTuneResult::Aborted);
+            break;
+        case T::Home:
+        case T::Recalibrate:   // 사용자 개입: full homing + calibration
+            warm.travelSteps = 0;
+            warm.verifying = false;
+            resetForHoming(true);
+            break;
+        case T::InjectFault: fault((MotionError)c.b0); return false;
+        case T::ForceMoveLeft:  enterForcedMove(false); break;
+        case T::ForceMoveRight: enterForcedMove(true); break;
+        case T::Start:       startIfStopped(); break;
+
+        case T::LedAuto:     led.mode = LedMode::Auto; break;
+        case T::LedManual:   led.mode = LedMode::Manual; led.manualOn = c.b0 != 0; break;
+        case T::LedSchedule: led.onStartMin = (uint16_t)c.u0; led.onEndMin = (uint16_t)c.u1; break;
+        case T::Clock:       led.clockValid = true; led.clockMin = (uint16_t)(c.u0 % 1440); break;
+
+        case T::AckAlert:
+            if (alerts.seq == c.u0) {
+                alerts.pending = false;
+                alerts.pendingCode = 0;
+                syncAlertStatus();
+            }
+            break;
+        case T::UiMute:      uiMuteUntilMs = millis() + c.u0 * 1000UL; break;
+
+        case T::SimHallLeft:  simulateHall(true, (uint16_t)c.u0); break;
+        case T::SimHallRight: simulateHall(false, (uint16_t)c.u0); break;
+
+        case T::FactoryStart:  startFactoryAutoTestNow(c.u0, (uint16_t)c.u1); fautoApplied++; break;
+        case T::FactoryStop:   fauto.running = false; autoHall.enabled = false; break;  // 🔥 반드시 AutoHall 끈다
+        case T::FactoryResult: recordFactoryResultNow(c.b0 != 0, c.b1, c.b2, c.u0, c.u1); break;
+
+        case T::StallPulseTimeout: safety.pulseStallTimeoutMs = c.u0; break;
+        case T::StallNoEndTimeout: safety.noEndTimeoutMs = c.u0; break;
+        case T::StepCatchUp:
+            catchUp.enabled = c.b0 != 0;
+            catchUp.maxBurstSteps = c.b1 ? c.b1 : 1;
+            catchUp.capPercent = (uint16_t)c.u0;
+            break;
+        case T::StepMicrostep:
+            ustep.enabled = c.b0 != 0 && msWired;
+            ustep.fineDiv = (c.b1 >= 1 && c.b1 <= 32) ? c.b1 : 16;
+            ustep.coarseDiv = (c.b2 >= 1 && c.b2 <= ustep.fineDiv) ? c.b2 : ustep.fineDiv;
+            ustep.coarseAboveSps = c.u0;
+            ustep.fineBelowSps = (c.u1 < c.u0) ? c.u1 : c.u0;
+            // pins take the (possibly new) fine divisor at the next stop
+            if (!isMovingState(st.state)) applyUstepShift(0);
+            break;
+        case T::DriftComp:
+            drift.enabled = c.b0 != 0;
+            drift.rehomeAboveSteps = c.u0;
+            if (!drift.enabled) drift.rehomePending = false;
+            break;
+        case T::PosWindow:
+            posWindow.enabled = c.b0 != 0;
+            posWindow.warnSteps = c.u0;
+            posWindow.faultSteps = c.u1;
+            break;
+        case T::HomingMode:
+            homing.twoStage = c.b0 != 0;
+            homing.blindSeekPercent = (c.u0 >= 100) ? (uint16_t)c.u0 : 100;
+            homing.backoffSteps = c.u1;
+            break;
+        case T::HallGlitch:
+            hallGlitchUs = c.u0;
+            break;
+        case T::ResetStepTiming:
+            st.stepLateMaxUs = 0;
+            st.stepOverruns = 0;
+            st.stepCatchUp = 0;
+            st.stepDropped = 0;
+            for (uint8_t i = 0; i < MotionStatus::kStepJitterBins; i++) st.stepJitterHist[i] = 0;
+            st.stepJitterSamples = 0;
+            st.stepJitterWorstUs = 0;
+            st.stepJitterWorstCmdUs = 0;
+            st.stepJitterWorstState = MotionState::Stopped;
+            st.stepJitterWorstMs = 0;
+            st.stepLostUs = 0;
+            st.stepRecoveredUs = 0;
+            st.hallReactMaxUs = 0;
+            st.hallOvershootMax = 0;
+            if (stepGen) stepGen->resetTimingStats();
+            break;
+    }
+    return true;
+}
+
+void MotionController::startIfStopped() {
+    // If stopped, start by homing. Otherwise ignore (already running).
+    if (st.state == MotionState::Stopped) startFromRest(true);
+    else if (st.state == MotionState::Stopping) stopping.restartAfter = true;   // resume once parked
+}
+
+void MotionController::emitAlert(uint8_t code, uint32_t seq, uint32_t uptimeMs, uint32_t cycles) {
+    MotionEvent e;
+    e.type = MotionEvent::Type::Alert;
+    e.code = code; e.seq = seq; e.uptimeMs = uptimeMs; e.cycles = cycles;
+    evtQ.push(e);
+}
+
+void MotionController::pollEvents() {
+#if MOTION_ON_CORE1
+    stPub.read(view.st);
+    cfgPub.read(view.cfg);
+#endif
+
+    MotionEvent e;
+    while (evtQ.pop(e)) {
+        if (e.type == MotionEvent::Type::Alert) {
+            if (alerts.cb) alerts.cb(channelIdx, e.code, e.seq, e.uptimeMs, e.cycles);
+        } else if (e.type == MotionEvent::Type::Factory) {
+            if (factory.cb) factory.cb(channelIdx, e.seq, e.pass, e.code, e.failStep, e.durationMs, e.uptimeMs, e.cycles);
+        } else {
+            if (tune.cb) tune.cb(channelIdx, e.seq, (AutoTuneResult)e.code, e.failStep, e.sps, e.accel);
+        }
+    }
+}
+
+#if MOTION_ON_CORE1
+void MotionController::publishBootStatus(const MotionConfig& bootCfg) {
+    // sole writer until core1 starts (the release/acquire on the start flag orders it)
+    cfg = bootCfg;
+    hotPub.write(makeHot(st));
+    stPub.write(st);
+    cfgPub.write(cfg);
+    view.st = st;
+    view.cfg = cfg;
+}
+
+void MotionController::publishStatus(uint32_t nowUs) {
+    hotPub.write(makeHot(st));
+
+    const bool changed = (st.state != pubState) || (st.err != pubErr) ||
+                         (st.alertSeq != pubAlertSeq) || (st.factorySeq != pubFactorySeq);
+    if (changed || (uint32_t)(nowUs - lastFullPublishUs) >= kFullPublishUs) {
+        stPub.write(st);
+        lastFullPublishUs = nowUs;
+        pubState = st.state;
+        pubErr = st.err;
+        pubAlertSeq = st.alertSeq;
+        pubFactorySeq = st.factorySeq;
+    }
+    if (cfgChanged) {
+        cfgPub.write(cfg);
+        cfgChanged = false;
+    }
+}
+#else
+void MotionController::publishStatus(uint32_t) {}
+#endif
+
 // ---- tick ----
 void MotionController::tick() {
+    tickMotion();
+    publishStatus(micros());
+}
+
+static inline uint32_t msLeft(uint32_t elapsed, uint32_t total) {
+    return (elapsed >= total) ? 0 : total - elapsed;
+}
+static inline void capWait(uint32_t& wait, uint32_t ms) { if (ms < wait) wait = ms; }
+
+uint32_t MotionController::msUntilNextTick() const {
+    if (!cmdQ.empty()) return 0;
+#if MOTION_HALL_IRQ
+    if (!hallQ.empty() || hallIn[0].pending || hallIn[1].pending) return 0;
+#endif
+    const uint32_t nowMs = millis();
+    uint32_t wait = kIdleWakeMaxMs;
+    if (autoHall.enabled) capWait(wait, msLeft(nowMs - autoHall.lastToggleMs, autoHall.intervalMs));
+    if (sim.leftActive) capWait(wait, (nowMs >= sim.leftUntilMs) ? 0 : sim.leftUntilMs - nowMs);
+    if (sim.rightActive) capWait(wait, (nowMs >= sim.rightUntilMs) ? 0 : sim.rightUntilMs - nowMs);
+
+    const uint32_t inState = nowMs - stateEnterMs;
+    switch (st.state) {
+        case MotionState::Stopped:
+            break;
+        case MotionState::Dwell:
+            capWait(wait, msLeft(inState, dwellTimeMs()));
+            break;
+        case MotionState::ProgramHold:
+            capWait(wait, msLeft(inState, program.holdMs));
+            break;
+        case MotionState::Fault:
+        case MotionState::RecoverWait:
+            if (!st.permanentFault) capWait(wait, msLeft(inState, 2000));
+            break;
+        default:
+            return 0;   // moving / homing: steps and halls need every tick
+    }
+    return wait;
+}
+
+void MotionController::tickMotion() {
     const uint32_t nowMs = millis();
     const uint32_t nowUs = micros();
 
+    // Apply queued requests first (config, LED policy, commands) in arrival order.
+    MotionCommand cmd;
+    while (cmdQ.pop(cmd)) {
+        if (!applyCommand(cmd)) return;
+    }
+
     // --- Auto Hall Toggle (test mode) ---
     // This runs BEFORE reading real pins, so simulation can drive the FSM.
     if (autoHall.enabled) {
         if ((uint32_t)(nowMs - autoHall.lastToggleMs) >= autoHall.intervalMs) {
             autoHall.lastToggleMs = nowMs;
 
-            if (autoHall.nextLeft) requestSimulateHallLeft((uint16_t)autoHall.pulseMs);
-            else                  requestSimulateHallRight((uint16_t)autoHall.pulseMs);
+            simulateHall(autoHall.nextLeft, (uint16_t)autoHall.pulseMs);
 
             autoHall.nextLeft = !autoHall.nextLeft;
         }
@@ -177,55 +638,23 @@ void MotionController::tick() {
     const bool ledShouldBeOn = evalLedShouldBeOn();
     applyLedAndMotorPolicy(ledShouldBeOn);
 
-    // Apply pending parameter requests at the top of the tick.
-    if (pending.setMaxSps) { cfg.maxSps = pending.maxSps; pending.setMaxSps = false; }
-    if (pending.setAccel)  { cfg.accel  = pending.accel;  pending.setAccel  = false; }
-    if (pending.setDwell)  { cfg.dwellMs= pending.dwellMs;pending.setDwell  = false; }
-    if (pending.setRehome) { cfg.rehomeEveryCycles = pending.rehomeEvery; pending.setRehome = false; }
-
-    // Command requests (start/stop/home/recalibrate)
-    if (pending.stop) {
-        pending.stop = false;
-        enterStopped(nowMs);
-    }
-
-    if (pending.home || pending.recalibrate) {
-        pending.home = false;
-        pending.recalibrate = false;
-        resetForHoming(true);  // 사용자 개입
-    }
-
-    if (pending.injectFault) {
-        pending.injectFault = false;
-        fault(pending.faultToInject);
-        return;
-    }
-
-    if (pending.forceMoveLeft) {
-        pending.forceMoveLeft = false;
-        enterForcedMove(false);
-    }
-    if (pending.forceMoveRight) {
-        pending.forceMoveRight = false;
-        enterForcedMove(true);
-    }
-
-    if (pending.start) {
-        pending.start = false;
-        // If stopped, start by homing. Otherwise ignore (already running).
-        if (st.state == MotionState::Stopped) resetForHoming(true);
-    }
-
     // --- Test simulation expire (for UI/Test menu) ---
     if (sim.leftActive && nowMs >= sim.leftUntilMs) sim.leftActive = false;
     if (sim.rightActive && nowMs >= sim.rightUntilMs) sim.rightActive = false;
 
-    st.hallRawL = (uint8_t)digitalRead(PIN_HALL_LEFT);
-    st.hallRawR = (uint8_t)digitalRead(PIN_HALL_RIGHT);
+    st.hallRawL = (uint8_t)digitalRead(pins.hallLeft);
+    st.hallRawR = (uint8_t)digitalRead(pins.hallRight);
 
+#if MOTION_HALL_IRQ
+    // Filtered levels from the ISR edge queue; raw reads above are diagnostics only.
+    drainHallEdges(nowUs);
+    bool hallL = hallIn[0].level;
+    bool hallR = hallIn[1].level;
+#else
     // Hall polarity is configurable via HALL_ACTIVE_LOW.
     bool hallL = HALL_ACTIVE_LOW ? (st.hallRawL == LOW) : (st.hallRawL == HIGH);
     bool hallR = HALL_ACTIVE_LOW ? (st.hallRawR == LOW) : (st.hallRawR == HIGH);
+#endif
 
     // Simulation overrides
     if (sim.leftActive)  hallL = true;
@@ -250,14 +679,22 @@ void MotionController::tick() {
 
     // If LED policy says OFF, motor is forced disabled and we keep Stopped.
     if (!ledShouldBeOn) {
+        // let a moving stroke ramp down first so the position survives the LED-off period
+        if (isMovingState(st.state) && st.state != MotionState::Stopping) beginControlledStop(nowMs);
+        if (st.state == MotionState::Stopping) {
+            stopping.restartAfter = false;
+            program.runAfterStop = false;
+            tickStopping(nowMs, nowUs);
+            return;
+        }
         if (st.state != MotionState::Stopped) enterStopped(nowMs);
         return;
     }
 
     if (st.state == MotionState::Stopped) {
         drv.enable(false);
-        st.currentSps = 0;
-        st.targetSps = 0;
+        setSpeed(0);
+        setTarget(0);
         return;
     }
 
@@ -274,7 +711,9 @@ void MotionController::tick() {
         // Auto-derive a conservative limit from current learned travel + dwell.
         noEndLimit = deriveNoEndTimeoutMs();
     }
-    if ((nowMs - safety.lastEndHitMs) > noEndLimit) {
+    // a program may legitimately stay away from both ends (position window / timeout still apply)
+    const bool inProgram = (st.state == MotionState::ProgramMove || st.state == MotionState::ProgramHold);
+    if (!inProgram && (nowMs - safety.lastEndHitMs) > noEndLimit) {
         fault(MotionError::MotionStall);
         return;
     }
@@ -302,7 +741,8 @@ void MotionController::tick() {
         return;
     }
 
-    if (st.state == MotionState::HomingLeft) {
+    if (st.state == MotionState::HomingLeft || st.state == MotionState::HomingSeek ||
+        st.state == MotionState::HomingBackoff) {
         if (nowMs - stateEnterMs > cfg.homingTimeoutMs) {
             fault(MotionError::HomingTimeout);
             return;
@@ -312,11 +752,11 @@ void MotionController::tick() {
             fault(MotionError::CalibFailed);
             return;
         }
-    } else if (st.state == MotionState::MoveLeft || st.state == MotionState::MoveRight) {
+    } else if (st.state == MotionState::MoveLeft || st.state == MotionState::MoveRight ||
+               st.state == MotionState::ProgramMove) {
         uint32_t limitMs = cfg.travelTimeoutMs;
         if (st.travelSteps > 0) {
-            float t = (float)st.travelSteps / maxf(cfg.minSps, 1.0f);
-            limitMs = (uint32_t)(t * 1000.0f) + 5000;
+            limitMs = travelMs(st.travelSteps, fx.minSpsInt) + 5000;
         }
         if (nowMs - stateEnterMs > limitMs) {
             fault(MotionError::TravelTimeout);
@@ -331,118 +771,227 @@ void MotionController::tick() {
             fauto.running = false;
             const uint32_t durMs = millis() - fauto.startMs;
             // MotionError를 failCode로 기록
-            recordFactoryResult(false, (uint8_t)st.err, fauto.failStep, durMs, millis());
+            recordFactoryResultNow(false, (uint8_t)st.err, fauto.failStep, durMs, millis());
         } else {
             // PASS 조건: 목표 cycles 달성
             const uint16_t progressed = (uint16_t)(st.cycles - fauto.startCycles);
             if (progressed >= fauto.targetCycles) {
                 fauto.running = false;
                 const uint32_t durMs = millis() - fauto.startMs;
-                recordFactoryResult(true, 0, fauto.failStep, durMs, millis());
+                recordFactoryResultNow(true, 0, fauto.failStep, durMs, millis());
             }
         }
     }
 
     switch (st.state) {
-        case MotionState::HomingLeft:
+        case MotionState::HomingSeek:
             drv.enable(true);
             drv.setDir(false);
-            st.targetSps = cfg.minSps;
-            rampSpeed(nowMs, false);
-            if (stepDue(nowUs)) {
-                doStep(false, nowMs, nowUs);
+            if (!planner.active()) {
+                // blind seek: no decel ahead of the hall, so keep it moderate
+                uint32_t seek = (fx.minSpsInt * homing.blindSeekPercent) / 100u;
+                q16 seekQ = fromInt(seek);
+                if (seekQ > fx.maxSps) seekQ = fx.maxSps;
+                setTarget(seekQ);
+                rampSpeed(nowMs, false);
             }
+            runSteps(false, nowMs, nowUs);
             if (st.hallL) {
-                st.pos = 0;
-                st.currentSps = 0;
-                st.targetSps = cfg.minSps;
-                st.travelSteps = 0;
-                st.state = MotionState::CalibMoveRight;
+                const bool slow = st.currentSps <= fx.minSpsInt;
+                stopStepGen();
+                if (slow) {
+                    // already at approach speed (planned seek crawled in, or started on the hall)
+                    finishHoming(nowMs, nowUs);
+                    break;
+                }
+                takeEndHitPos(true, st.pos);   // coarse edge, only used to release the latch
+                st.state = MotionState::HomingBackoff;
                 stateEnterMs = nowMs;
                 lastStepUs = nowUs;
-                st.err = MotionError::None;
-                calibSteps = 0;
-                moveSteps = 0;
+                lastRampMs = nowMs;
+                setSpeed(0);
+                homing.backoffLeft = homing.backoffSteps;
             }
             break;
 
-        case MotionState::CalibMoveRight:
+        case MotionState::HomingBackoff:
             drv.enable(true);
             drv.setDir(true);
-            st.targetSps = cfg.maxSps;
+            setTarget(fx.minSps);
+            rampSpeed(nowMs, false);
+            {
+                const uint32_t n = runSteps(true, nowMs, nowUs);
+                // distance counts only once the hall has released
+                if (!st.hallL) homing.backoffLeft = (n >= homing.backoffLeft) ? 0 : homing.backoffLeft - n;
+            }
+            if (homing.backoffLeft == 0) {
+                stopStepGen();
+                st.state = MotionState::HomingLeft;
+                stateEnterMs = nowMs;
+                lastStepUs = nowUs;
+                lastRampMs = nowMs;
+                setSpeed(0);
+            }
+            break;
+
+        case MotionState::HomingLeft:
+            drv.enable(true);
+            drv.setDir(false);
+            setTarget(fx.minSps);
             rampSpeed(nowMs, false);
-            if (stepDue(nowUs)) {
-                doStep(true, nowMs, nowUs);
-                calibSteps++;
+            runSteps(false, nowMs, nowUs);
+            if (st.hallL) {
+                stopStepGen();
+                finishHoming(nowMs, nowUs);
             }
+            break;
+
+        case MotionState::CalibMoveRight:
+            drv.enable(true);
+            drv.setDir(true);
+            setTarget(fx.maxSps);
+            rampSpeed(nowMs, false);
+            calibSteps += runSteps(true, nowMs, nowUs);
             if (st.hallR) {
-                st.travelSteps = calibSteps;
+                calibSteps += stopStepGen();
+                {
+                    const long edge = takeEndHitPos(false, st.pos);
+                    st.travelSteps = (edge > 0) ? (uint32_t)edge : calibSteps;
+                }
                 calibSteps = 0;
                 enterDwell(nowMs, MotionState::MoveLeft);
+                if (homingTimed) {
+                    st.rehomeMsLast = nowMs - homingStartMs;
+                    homingTimed = false;
+                }
             }
             break;
 
         case MotionState::MoveRight:
             drv.enable(true);
             drv.setDir(true);
-            st.targetSps = cfg.maxSps;
-            rampSpeed(nowMs, true);
-            if (stepDue(nowUs)) {
-                doStep(true, nowMs, nowUs);
-                moveSteps++;
-            }
+            setTarget(fx.maxSps);
+            if (!planner.active()) rampSpeed(nowMs, true);
+            moveSteps += runSteps(true, nowMs, nowUs);
             if (st.hallR) {
                 enterDwell(nowMs, MotionState::MoveLeft);
+                const long edge = takeEndHitPos(false, st.pos);
+                if (!checkPositionWindow(edge - (long)st.travelSteps, true)) break;
+                autoTuneEndHit(edge - (long)st.travelSteps);
+                compensateDrift(false, edge);
+                if (dwellTimeMs() == 0) leaveDwell(nowMs, nowUs);   // reverse in the same tick
+            } else {
+                checkPositionWindow(st.pos - (long)st.travelSteps, false);
             }
             break;
 
         case MotionState::MoveLeft:
             drv.enable(true);
             drv.setDir(false);
-            st.targetSps = cfg.maxSps;
-            rampSpeed(nowMs, true);
-            if (stepDue(nowUs)) {
-                doStep(false, nowMs, nowUs);
-                moveSteps++;
-            }
+            setTarget(fx.maxSps);
+            if (!planner.active()) rampSpeed(nowMs, true);
+            moveSteps += runSteps(false, nowMs, nowUs);
             if (st.hallL) {
                 if (lastWasRightEnd) {
                     st.cycles++;
                     lastWasRightEnd = false;
                 }
                 enterDwell(nowMs, MotionState::MoveRight);
+                const long edge = takeEndHitPos(true, st.pos);
+                if (!checkPositionWindow(-edge, true)) break;
+                autoTuneEndHit(edge);
+                compensateDrift(true, edge);
+                if (dwellTimeMs() == 0) leaveDwell(nowMs, nowUs);
+            } else {
+                checkPositionWindow(-st.pos, false);
             }
             break;
 
-        case MotionState::Dwell:
-            drv.enable(false);
-            st.currentSps = 0;
-            if (nowMs - stateEnterMs >= cfg.dwellMs) {
-                if (st.cycles > 0 && (st.cycles % cfg.rehomeEveryCycles) == 0) {
-                    resetForHoming(true);
-                    return;
-                }
-                st.state = nextAfterDwell;
-                stateEnterMs = nowMs;
-                moveSteps = 0;
-                lastStepUs = nowUs;
-                if (nextAfterDwell == MotionState::MoveLeft) lastWasRightEnd = true;
+        case MotionState::Stopping:
+            tickStopping(nowMs, nowUs);
+            break;
+
+        case MotionState::ProgramMove:
+            tickProgramMove(nowMs, nowUs);
+            break;
+
+        case MotionState::ProgramHold:
+            drv.enable(true);   // holding torque keeps the position exact
+            setSpeed(0);
+            if (nowMs - stateEnterMs >= program.holdMs) {
+                programAdvance();
+                programNext(nowMs, nowUs);
             }
             break;
 
+        case MotionState::Dwell:
+            // Continuous reversal keeps holding torque through the short settle
+            if (cfg.reversal == ReversalMode::Dwell) drv.enable(false);
+            setSpeed(0);
+            if (nowMs - stateEnterMs >= dwellTimeMs()) leaveDwell(nowMs, nowUs);
+            break;
+
         default:
             break;
     }
 }
 
 // ---- internal helpers ----
+uint32_t MotionController::dwellTimeMs() const {
+    return (cfg.reversal == ReversalMode::Continuous) ? cfg.reverseSettleMs : cfg.dwellMs;
+}
+
+void MotionController::leaveDwell(uint32_t nowMs, uint32_t nowUs) {
+    // Periodic rehome fires once per multiple of rehomeEveryCycles (cycles
+    // doesn't advance across the rehome itself).
+    const bool periodic = st.cycles > 0 && cfg.rehomeEveryCycles > 0 &&
+                          (st.cycles % cfg.rehomeEveryCycles) == 0 &&
+                          st.cycles != drift.lastPeriodicCycle;
+    if (periodic) drift.lastPeriodicCycle = st.cycles;
+    if (drift.rehomePending) {
+        drift.rehomePending = false;
+        st.driftRehomes++;
+        resetForHoming(true);
+        return;
+    }
+    if (periodic) {
+        if (drift.enabled && st.travelSteps > 0) {
+            st.rehomesAvoided++;   // end hits kept pos within the drift limit
+        } else {
+            resetForHoming(true);
+            return;
+        }
+    }
+    st.state = nextAfterDwell;
+    stateEnterMs = nowMs;
+    moveSteps = 0;
+    posWindow.warned = false;
+    lastStepUs = nowUs;
+    lastRampMs = nowMs;
+    planStroke();
+    if (nextAfterDwell == MotionState::MoveLeft) lastWasRightEnd = true;
+}
 void MotionController::resetForHoming(bool userInitiated) {
+    stopStepGen();
+    clearHallLatches();
+    homingStartMs = millis();
+    homingTimed = true;
+
+    // A clean rehome (periodic/drift/user, no fault) still knows roughly where it is:
+    // the seek can then cruise at maxSps and decelerate before the expected switch point.
+    const long slack = (long)homing.backoffSteps;
+    const bool trusted = homing.twoStage && st.err == MotionError::None && st.posValid &&
+                         st.travelSteps > 0 && st.pos > slack &&
+                         st.pos <= (long)st.travelSteps + slack;
+    const long seekFrom = st.pos;
+
     drv.enable(true);
-    st.state = MotionState::HomingLeft;
+    st.state = homing.twoStage ? MotionState::HomingSeek : MotionState::HomingLeft;
     st.err = MotionError::None;
-    st.currentSps = 0;
-    st.targetSps = cfg.minSps;
-    st.pos = 0;
+    setSpeed(0);
+    setTarget(fx.minSps);
+    st.pos = trusted ? seekFrom : 0;
+    st.posValid = false;
     stateEnterMs = millis();
     lastStepUs = micros();
     lastRampMs = stateEnterMs;
@@ -453,12 +1002,92 @@ void MotionController::resetForHoming(bool userInitiated) {
     lastWasRightEnd = false;
     st.travelSteps = 0;
 
+    if (trusted) planMove((uint32_t)(seekFrom - slack), toInt(fx.maxSps));
+
     if (userInitiated) {
         st.recoverAttempts = 0;
         st.permanentFault = false;
     }
 }
 
+void MotionController::startFromRest(bool userInitiated) {
+    warm.travelSteps = 0;
+    warm.verifying = false;
+    if (st.travelSteps == 0) {
+        resetForHoming(userInitiated);
+        return;
+    }
+
+    const long slack = (long)homing.backoffSteps;
+    if (!st.posValid || st.pos < -slack || st.pos > (long)st.travelSteps + slack) {
+        // travel known, position not: home, then skip calibration
+        warm.travelSteps = st.travelSteps;
+        resetForHoming(userInitiated);
+        return;
+    }
+
+    // Resume from the parked position: continue toward the end the stopped stroke (or
+    // dwell) was heading for (left after a boot); that end hit verifies pos.
+    const bool right = stopping.headingRight && st.pos < (long)st.travelSteps;
+    const long dist = right ? (long)st.travelSteps - st.pos : st.pos;
+    stopping.headingRight = false;
+
+    const uint32_t nowMs = millis();
+    stopStepGen();
+    clearHallLatches();
+    drv.enable(true);
+    st.err = MotionError::None;
+    st.state = right ? MotionState::MoveRight : MotionState::MoveLeft;
+    stateEnterMs = nowMs;
+    lastStepUs = micros();
+    lastRampMs = nowMs;
+    safety.lastStepPulseMs = nowMs;
+    setSpeed(0);
+    setTarget(fx.maxSps);
+    moveSteps = 0;
+    calibSteps = 0;
+    lastWasRightEnd = false;
+    warm.verifying = true;
+    posWindow.warned = false;
+    if (dist > 1) planZoned(st.pos, right ? (long)st.travelSteps : 0);
+    else planMove(1u, toInt(fx.maxSps));
+
+    if (userInitiated) {
+        st.recoverAttempts = 0;
+        st.permanentFault = false;
+    }
+}
+
+void MotionController::finishHoming(uint32_t nowMs, uint32_t nowUs) {
+    // zero = the switch point itself; the overshoot past it stays in pos
+    st.pos -= takeEndHitPos(true, st.pos);
+    st.posValid = true;
+    setSpeed(0);
+    setTarget(fx.minSps);
+
+    if (warm.travelSteps > 0) {
+        // warm start: reuse the learned travel, the first right-end hit verifies it
+        st.travelSteps = warm.travelSteps;
+        warm.travelSteps = 0;
+        warm.verifying = true;
+        st.err = MotionError::None;
+        if (homingTimed) {
+            st.rehomeMsLast = nowMs - homingStartMs;
+            homingTimed = false;
+        }
+        enterDwell(nowMs, MotionState::MoveRight);
+        return;
+    }
+
+    st.travelSteps = 0;
+    st.state = MotionState::CalibMoveRight;
+    stateEnterMs = nowMs;
+    lastStepUs = nowUs;
+    st.err = MotionError::None;
+    calibSteps = 0;
+    moveSteps = 0;
+}
+
 //-----------------------------------------------
 // BEGIN:: Auto Test, FactoryAutoTest
 //-----------------------------------------------
@@ -484,7 +1113,13 @@ uint32_t MotionController::autoHallIntervalMs() const {
 }
 
 void MotionController::startFactoryAutoTest(uint32_t hallIntervalMs, uint16_t targetCycles) {
+    MotionCommand c = makeCmd(MotionCommand::Type::FactoryStart);
+    c.u0 = hallIntervalMs; c.u1 = targetCycles;
+    fautoRequested++;
+    enqueue(c);
+}
 
+void MotionController::startFactoryAutoTestNow(uint32_t hallIntervalMs, uint16_t targetCycles) {
     if (targetCycles == 0) targetCycles = 10;
 
     fauto.running = true;
@@ -494,42 +1129,321 @@ void MotionController::startFactoryAutoTest(uint32_t hallIntervalMs, uint16_t ta
     fauto.failStep = 1;
 
     // UI 알림 억제 (테스트 중 방해 방지)
-    setUiMuteSeconds(60);
+    uiMuteUntilMs = millis() + 60UL * 1000UL;
 
     // 테스트 조건 강제
-    setLedModeManual(true);
+    led.mode = LedMode::Manual;
+    led.manualOn = true;
     autoHall.intervalMs = hallIntervalMs;
     autoHall.enabled = true;
     autoHall.lastToggleMs = millis();
     autoHall.nextLeft = true;
-    
-    requestStart();
+
+    startIfStopped();
 }
 
 void MotionController::stopFactoryAutoTest() {
-    fauto.running = false;
-
-    // 🔥 반드시 AutoHall 끈다
-    autoHall.enabled = false;
+    enqueue(makeCmd(MotionCommand::Type::FactoryStop));
 }
 
-bool MotionController::isFactoryAutoTestRunning() const { return fauto.running; }
+// A queued start counts as running so core0 doesn't see a false "finished" before core1 applies it.
+bool MotionController::isFactoryAutoTestRunning() const { return fauto.running || (fautoApplied != fautoRequested); }
 uint16_t MotionController::factoryAutoTargetCycles() const { return fauto.targetCycles; }
 uint16_t MotionController::factoryAutoStartCycles() const { return fauto.startCycles; }
 // END:: Auto Test, FactoryAutoTest
 //-----------------------------------------------
 
+//-----------------------------------------------
+// BEGIN:: Auto Tune (stall-margin search)
+//-----------------------------------------------
+void MotionController::startAutoTune(const MotionAutoTunePolicy& p) {
+    MotionCommand c = makeCmd(MotionCommand::Type::AutoTuneStart);
+    c.b0 = p.stepPercent; c.b1 = p.hitsPerStage; c.b2 = p.marginPercent;
+    c.u0 = p.lostStepLimit; c.u1 = p.maxStages; c.f = p.spsCeiling;
+    enqueue(c);
+}
+
+void MotionController::stopAutoTune() {
+    enqueue(makeCmd(MotionCommand::Type::AutoTuneStop));
+}
+
+void MotionController::startAutoTuneNow(const MotionAutoTunePolicy& p) {
+    if (tune.running) return;
+
+    tune.begin(p, cfg.maxSps, cfg.accel, (float)MOTION_SPS_EDIT_MAX);
+
+    st.autoTuneRunning = true;
+    st.autoTuneStage = 0;
+    st.autoTuneStagesPassed = 0;
+    st.autoTuneLostLast = 0;
+
+    // an uncalibrated bed learns its travel first; hits are only judged once it is known
+    startIfStopped();
+}
+
+void MotionController::autoTuneEndHit(long err) {
+    if (!tune.running || st.travelSteps == 0 || warm.verifying) return;
+
+    const AutoTuneSearch::Hit h = tune.endHit(err);
+    st.autoTuneStagesPassed = tune.passed;
+    switch (h) {
+        case AutoTuneSearch::Hit::Counted:
+            break;
+        case AutoTuneSearch::Hit::NextStage:
+            // takes effect with the next stroke plan (the hit that passed a stage plans it right after)
+            cfg.maxSps = tune.stageSps;
+            cfg.accel = tune.stageAccel;
+            applyFixedConfig();
+            st.autoTuneStage = tune.stage;
+            break;
+        case AutoTuneSearch::Hit::Ceiling:
+            finishAutoTune(AutoTuneResult::Ceiling);
+            break;
+        case AutoTuneSearch::Hit::LostSteps:
+            st.autoTuneLostLast = err;
+            finishAutoTune(AutoTuneResult::LostSteps);
+            break;
+    }
+}
+
+void MotionController::finishAutoTune(AutoTuneResult result) {
+    float sps, accel;
+    tune.finish(result, cfg.minSps, sps, accel);
+    cfg.maxSps = sps;
+    cfg.accel = accel;
+    applyFixedConfig();
+
+    tune.seq++;
+    st.autoTuneRunning = false;
+    st.autoTuneSeq = tune.seq;
+    st.autoTuneResult = result;
+    st.autoTuneSps = (uint32_t)sps;
+    st.autoTuneAccel = (uint32_t)accel;
+
+    MotionEvent e;
+    e.type = MotionEvent::Type::AutoTune;
+    e.seq = tune.seq; e.code = (uint8_t)result; e.failStep = st.autoTuneStagesPassed;
+    e.sps = st.autoTuneSps; e.accel = st.autoTuneAccel;
+    e.uptimeMs = millis(); e.cycles = st.cycles;
+    evtQ.push(e);
+}
+// END:: Auto Tune
+//-----------------------------------------------
+
 void MotionController::enterStopped(uint32_t nowMs) {
+    if (tune.running) finishAutoTune(AutoTuneResult::Aborted);   // a stop aborts the search
+    // cutting a moving stroke loses steps; a stop at rest (Dwell, or before the first
+    // pulse) keeps pos exact
+    if (isMovingState(st.state) && steppedSinceRest) st.posValid = false;
+    if (st.state == MotionState::Dwell) stopping.headingRight = (nextAfterDwell == MotionState::MoveRight);
+    stopStepGen();
+    steppedSinceRest = false;
     st.state = MotionState::Stopped;
-    st.currentSps = 0;
-    st.targetSps = 0;
+    setSpeed(0);
+    setTarget(0);
     drv.enable(false);
     stateEnterMs = nowMs;
 }
 
+void MotionController::beginControlledStop(uint32_t nowMs) {
+    if (tune.running) finishAutoTune(AutoTuneResult::Aborted);
+    const MotionState s = st.state;
+    stopping.forward = (s == MotionState::MoveRight || s == MotionState::CalibMoveRight ||
+                        s == MotionState::HomingBackoff ||
+                        (s == MotionState::ProgramMove && program.forward));
+    stopping.headingRight = stopping.forward;
+
+    // Pulses already queued are dropped (pos counts only emitted ones); the ramp restarts
+    // from the speed we are actually running at.
+    const q16 v = fromInt(st.currentSps);
+    stopStepGen();
+    setSpeed(v);
+    setTarget(fx.minSps);
+    lastRampMs = nowMs;
+    st.state = MotionState::Stopping;
+    stateEnterMs = nowMs;
+
+    // bound: (v - minSps) / accel, plus the accel taper (accel / jerk) of the S-curve ramp
+    const uint32_t dv = (st.currentSps > fx.minSpsInt) ? st.currentSps - fx.minSpsInt : 0;
+    uint32_t ms = (uint32_t)(((uint64_t)dv * 1000u) / fx.accel);
+    if (fx.jerk) ms += (uint32_t)(((uint64_t)fx.accel * 1000u) / fx.jerk);
+    stopping.timeoutMs = ms + kStoppingMarginMs;
+}
+
+void MotionController::tickStopping(uint32_t nowMs, uint32_t nowUs) {
+    // checked here so the LED-off path (which returns before the safety checks) is bounded too
+    if (nowMs - stateEnterMs > stopping.timeoutMs) {
+        enterStopped(nowMs);   // ramp never finished: cut it, pos no longer trusted
+        return;
+    }
+
+    const bool fwd = stopping.forward;
+    drv.enable(true);
+    drv.setDir(fwd);
+    setTarget(fx.minSps);
+    rampSpeed(nowMs, false);
+
+    // minSps is the start/stop speed (strokes end there too), so stopping from it is step-exact.
+    // An end switch in the travel direction also ends it.
+    const bool atEnd = fwd ? st.hallR : st.hallL;
+    if (speedQ > fx.minSps && !atEnd) {
+        runSteps(fwd, nowMs, nowUs);
+        return;
+    }
+
+    stopStepGen();
+    steppedSinceRest = false;   // every emitted pulse is counted: pos stays valid
+    enterStopped(nowMs);
+    if (program.runAfterStop) {
+        program.runAfterStop = false;
+        stopping.restartAfter = false;
+        if (!startProgram(nowMs, nowUs)) st.programRejects++;
+    } else if (stopping.restartAfter) {
+        stopping.restartAfter = false;
+        startFromRest(true);
+    }
+}
+
+// ---- motion program ----
+bool MotionController::startProgram(uint32_t nowMs, uint32_t nowUs) {
+    if (program.count == 0 || st.travelSteps == 0) return false;
+    if (st.state == MotionState::ProgramMove || st.state == MotionState::ProgramHold) return false;
+
+    // a running stroke parks first (pos kept), then the program starts from there
+    if (st.state == MotionState::MoveLeft || st.state == MotionState::MoveRight) {
+        beginControlledStop(nowMs);
+        program.runAfterStop = true;
+        return true;
+    }
+    if (st.state == MotionState::Stopping) {
+        program.runAfterStop = true;
+        return true;
+    }
+    if (st.state == MotionState::Dwell) enterStopped(nowMs);
+    if (st.state != MotionState::Stopped || !st.posValid) return false;
+
+    warm.verifying = false;
+    st.err = MotionError::None;
+    programNext(nowMs, nowUs);
+    return true;
+}
+
+long MotionController::programPos(long v, bool fraction) const {
+    long p = v;
+    if (fraction) {
+        const uint32_t pm = (v < 0) ? 0u : (v > 1000) ? 1000u : (uint32_t)v;
+        p = (long)(((uint64_t)st.travelSteps * pm) / 1000u);
+    }
+    if (p < 0) p = 0;
+    if (p > (long)st.travelSteps) p = (long)st.travelSteps;
+    return p;
+}
+
+void MotionController::programAdvance() {
+    if (program.count == 0) return;
+    const MotionProgramStep& p = program.steps[program.head];
+    // Sweep legs: 0 -> a, then b, a, b, ... ending on a (2 * count + 1 legs)
+    if (p.op == MotionProgramStep::Op::Sweep && program.leg < 2u * p.count) {
+        program.leg++;
+        return;
+    }
+    program.head = (uint8_t)((program.head + 1) % ProgramQueue::kCapacity);
+    program.count--;
+    program.leg = 0;
+    st.programQueued = program.count;
+}
+
+void MotionController::programNext(uint32_t nowMs, uint32_t nowUs) {
+    while (program.count > 0) {
+        const MotionProgramStep& p = program.steps[program.head];
+        if (p.op == MotionProgramStep::Op::Hold) {
+            stopStepGen();
+            drv.enable(true);
+            st.state = MotionState::ProgramHold;
+            stateEnterMs = nowMs;
+            program.holdMs = (uint32_t)p.a;
+            setSpeed(0);
+            setTarget(0);
+            return;
+        }
+        const bool toB = p.op == MotionProgramStep::Op::Sweep && (program.leg & 1u);
+        const long target = programPos(toB ? p.b : p.a, p.fraction);
+        if (target != st.pos) {
+            beginProgramMove(target, p.sps, nowMs, nowUs);
+            return;
+        }
+        programAdvance();   // already there
+    }
+
+    // Done: park here. Refresh the end-hit clock so a later requestStart() isn't
+    // judged by the time spent in the program.
+    safety.lastEndHitMs = nowMs;
+    stopping.headingRight = program.forward;
+    enterStopped(nowMs);
+}
+
+void MotionController::beginProgramMove(long target, uint32_t sps, uint32_t nowMs, uint32_t nowUs) {
+    stopStepGen();
+    const bool fwd = target > st.pos;
+    const uint32_t dist = (uint32_t)(fwd ? target - st.pos : st.pos - target);
+    program.forward = fwd;
+    program.target = target;
+
+    drv.enable(true);
+    st.state = MotionState::ProgramMove;
+    stateEnterMs = nowMs;
+    lastStepUs = nowUs;
+    lastRampMs = nowMs;
+    safety.lastStepPulseMs = nowMs;
+    setSpeed(0);
+    setTarget(fx.minSps);
+    moveSteps = 0;
+
+    if (sps == 0) {
+        planZoned(st.pos, target);
+    } else {
+        const uint32_t maxInt = toInt(fx.maxSps);
+        planMove(dist, (sps > maxInt) ? maxInt : (sps < fx.minSpsInt) ? fx.minSpsInt : sps);
+    }
+}
+
+void MotionController::tickProgramMove(uint32_t nowMs, uint32_t nowUs) {
+    const bool fwd = program.forward;
+    drv.enable(true);
+    drv.setDir(fwd);
+    if (!planner.active()) rampSpeed(nowMs, false);
+
+    // pos only counts emitted pulses and the feed stops at the target, so left hits 0
+    // exactly once the generator queue has drained
+    const long left = fwd ? program.target - st.pos : st.pos - program.target;
+    const bool atEnd = fwd ? st.hallR : st.hallL;
+    if (left > 0 && !atEnd) {
+        moveSteps += runSteps(fwd, nowMs, nowUs);
+        return;
+    }
+
+    stopStepGen();
+    steppedSinceRest = false;   // every emitted pulse is counted: pos stays valid
+    if (atEnd && left > 0) {
+        // switch reached before the target: the switch point is the better reference
+        compensateDrift(!fwd, takeEndHitPos(!fwd, st.pos));
+        if (drift.rehomePending) {
+            drift.rehomePending = false;
+            st.driftRehomes++;
+            resetForHoming(true);   // the rest of the program stays queued
+            return;
+        }
+    }
+    programAdvance();
+    programNext(nowMs, nowUs);
+}
+
 void MotionController::fault(MotionError e) {
     const uint32_t now = millis();
 
+    // a faulted stage ends the search: the last passing stage (minus margin) is kept
+    if (tune.running) finishAutoTune(AutoTuneResult::Fault);
+
     // 최초 Fault 진입만 카운트 (Fault 상태에서 fault() 다시 호출되면 누적 방지)
     if (st.state != MotionState::Fault) {
         st.recoverAttempts++;             // retryCount (1..)
@@ -551,16 +1465,17 @@ void MotionController::fault(MotionError e) {
             alerts.pendingCode = (uint8_t)e;
         }
 
-        if (alerts.cb) {
-            // callback is useful for logging even during mute
-            alerts.cb((uint8_t)e, alerts.seq, now, st.cycles);
-        }
+        // callback is useful for logging even during mute (dispatched on core0 by pollEvents())
+        emitAlert((uint8_t)e, alerts.seq, now, st.cycles);
     }
 
+    stopStepGen();
+    st.posValid = false;
+    warm.verifying = false;
     st.state = MotionState::Fault;
     st.err = e;
-    st.currentSps = 0;
-    st.targetSps = 0;
+    setSpeed(0);
+    setTarget(0);
     drv.enable(false);
     stateEnterMs = now;
 
@@ -623,23 +1538,26 @@ void MotionController::syncAlertStatus() {
 }
 
 void MotionController::enterDwell(uint32_t nowMs, MotionState next) {
+    stopStepGen();
+    steppedSinceRest = false;
     st.state = MotionState::Dwell;
     nextAfterDwell = next;
     stateEnterMs = nowMs;
-    st.currentSps = 0;
-    st.targetSps = 0;
-    drv.enable(false);
+    setSpeed(0);
+    setTarget(0);
+    if (cfg.reversal == ReversalMode::Dwell) drv.enable(false);
     moveSteps = 0;
 }
 
 void MotionController::enterForcedMove(bool toRight) {
     // Engineering-only: move until a hall triggers or timeout.
     // We reuse MoveLeft/MoveRight states with travelSteps=0 so decel logic is disabled.
+    stopStepGen();
     drv.enable(true);
     st.err = MotionError::None;
     st.state = toRight ? MotionState::MoveRight : MotionState::MoveLeft;
-    st.targetSps = cfg.minSps;
-    st.currentSps = cfg.minSps;
+    setTarget(fx.minSps);
+    setSpeed(fx.minSps);
     st.travelSteps = 0;
     moveSteps = 0;
     stateEnterMs = millis();
@@ -649,23 +1567,512 @@ void MotionController::enterForcedMove(bool toRight) {
 }
 
 bool MotionController::stepDue(uint32_t nowUs) {
-    float sps = maxf(st.currentSps, 1.0f);
-    uint32_t intervalUs = (uint32_t)(1000000.0f / sps);
-    return (uint32_t)(nowUs - lastStepUs) >= intervalUs;
+    // ramp mode: pulse interval follows the current speed (one pulse = 1 << ustepShift units)
+    if (!planner.active()) pulseIntervalUs = stepIntervalUs << ustepShift;
+    if (!stepSchedValid) {
+        // (re)start the ideal schedule one interval after the last pulse/state entry
+        stepDueUs = lastStepUs + pulseIntervalUs;
+        stepSchedValid = true;
+    }
+    if ((int32_t)(nowUs - stepDueUs) < 0) return false;
+    if (!catchUp.enabled) return true;
+    // catch-up steps run at most capPercent above the speed this pulse was planned at, so a
+    // stall during accel or near minSps doesn't burst at maxSps (interval <= 32e6: no overflow)
+    const uint32_t pct = (catchUp.capPercent < 100) ? 100u : catchUp.capPercent;
+    return (uint32_t)(nowUs - lastStepUs) >= (pulseIntervalUs * 100u) / pct;
 }
 
 void MotionController::doStep(bool forward, uint32_t nowMs, uint32_t nowUs) {
+    const uint32_t late = nowUs - stepDueUs;   // stepDue() guarantees nowUs >= stepDueUs
+    if (late > st.stepLateMaxUs) st.stepLateMaxUs = late;
+    const uint32_t slotUs = pulseIntervalUs;   // interval this step was scheduled with
+    if (late >= slotUs) st.stepOverruns++;     // at least one whole step slot was missed
+    recordStepJitter(nowUs - lastStepUs, slotUs, nowMs);
+
     drv.stepPulse();
+    steppedSinceRest = true;
     lastStepUs = nowUs;
     safety.lastStepPulseMs = nowMs;
-    st.pos += forward ? 1 : -1;
+    const long units = (long)1 << ustepShift;
+    st.pos += forward ? units : -units;
+    if (planner.active()) pulseIntervalUs = nextStepIntervalUs();
+
+    if (!catchUp.enabled) {
+        // legacy: late time is dropped, next step one interval from now
+        stepDueUs = nowUs + pulseIntervalUs;
+        return;
+    }
+
+    // Keep the ideal schedule. If still behind, the next tick(s) emit catch-up steps
+    // (spaced by capPercent of the planned speed); a backlog beyond maxBurstSteps is dropped and counted.
+    stepDueUs += pulseIntervalUs;
+    const int32_t behindUs = (int32_t)(nowUs - stepDueUs);
+    if (behindUs >= 0) {
+        const uint32_t behindSteps = (uint32_t)behindUs / pulseIntervalUs + 1;
+        if (behindSteps > catchUp.maxBurstSteps) {
+            st.stepDropped += behindSteps - catchUp.maxBurstSteps;
+            stepDueUs = nowUs - (catchUp.maxBurstSteps - 1) * pulseIntervalUs;
+        }
+        st.stepCatchUp++;
+    }
+}
+
+void MotionController::recordStepJitter(uint32_t actualUs, uint32_t commandedUs, uint32_t nowMs) {
+    const int32_t dev = (int32_t)(actualUs - commandedUs);
+    const uint32_t mag = (dev < 0) ? (uint32_t)-dev : (uint32_t)dev;
+
+    uint8_t bin = 0;
+    for (uint32_t v = mag >> 3; v != 0 && bin < MotionStatus::kStepJitterBins - 1; v >>= 1) bin++;
+    if (st.stepJitterHist[bin] != 0xFFFF) st.stepJitterHist[bin]++;
+    st.stepJitterSamples++;
+
+    const uint32_t worst = (st.stepJitterWorstUs < 0) ? (uint32_t)-st.stepJitterWorstUs
+                                                      : (uint32_t)st.stepJitterWorstUs;
+    if (mag > worst) {
+        st.stepJitterWorstUs = dev;
+        st.stepJitterWorstCmdUs = commandedUs;
+        st.stepJitterWorstState = st.state;
+        st.stepJitterWorstMs = nowMs;
+    }
+
+    uint32_t& acc = (dev > 0) ? st.stepLostUs : st.stepRecoveredUs;
+    acc = (acc > 0xFFFFFFFFu - mag) ? 0xFFFFFFFFu : acc + mag;
+}
+
+uint32_t MotionController::runSteps(bool forward, uint32_t nowMs, uint32_t nowUs) {
+    const uint8_t want = desiredUstepShift(forward);
+
+    if (!stepGen) {
+        // Polled: switch between pulses. Going coarser waits until pos sits on a coarse
+        // boundary (at most a few more fine pulses) so the indexer stays aligned.
+        if (want != ustepShift &&
+            (want < ustepShift || unitsToAlign(st.pos, forward, 1u << want) == 0)) {
+            applyUstepShift(want);
+        }
+        if (!stepDue(nowUs)) return 0;
+        const uint32_t pulseUnits = 1u << ustepShift;
+        doStep(forward, nowMs, nowUs);
+        return pulseUnits;
+    }
+
+    stepGenForward = forward;
+    const uint32_t units = collectEmitted(nowMs) << ustepShift;
+    st.stepLateMaxUs = stepGen->maxLateUs();
+
+    // The generator keeps its own deadline schedule; an empty queue mid-move means
+    // tick() fell behind by more than kStepLeadMs and the stream stalled (underrun).
+    // The lead below is at least 2, so the pulse in its hold-off always had a successor.
+    if (stepGenStreaming && stepGen->queued() == 0) st.stepOverruns++;
+
+    // Microstep switch: pulses already queued belong to the current resolution, so
+    // finish the partial coarse step (if going coarser), let the queue drain, then switch.
+    uint32_t feedLimit = 0xFFFFFFFFu;
+    if (want != ustepShift) {
+        const long qUnits = (long)(stepGen->queued() << ustepShift);
+        const long posAfter = st.pos + (forward ? qUnits : -qUnits);
+        const uint32_t align = (want > ustepShift) ? unitsToAlign(posAfter, forward, 1u << want) : 0;
+        if (align > 0) {
+            feedLimit = align >> ustepShift;
+        } else if (stepGen->queued() == 0) {
+            applyUstepShift(want);
+        } else {
+            feedLimit = 0;
+        }
+    }
+
+    // Absolute move: never queue past the target (the tail is fine-stepped, see desiredUstepShift()).
+    if (st.state == MotionState::ProgramMove) {
+        const long qUnits = (long)(stepGen->queued() << ustepShift);
+        const long posAfter = st.pos + (forward ? qUnits : -qUnits);
+        const long left = forward ? program.target - posAfter : posAfter - program.target;
+        const uint32_t pulses = (left > 0) ? ((uint32_t)left >> ustepShift) : 0;
+        if (pulses < feedLimit) feedLimit = pulses;
+    }
+
+    // Keep a few ms of pulses queued so a slow ui.tick()/flash commit can't starve STEP.
+    // Intervals use the speed at push time; rampSpeed() counts queued steps as travelled.
+    // A lead of 1 would leave the queue empty after every pulse (each counted as an underrun).
+    const uint32_t lead = ((st.currentSps >> ustepShift) * kStepLeadMs) / 1000u + 2;
+    uint32_t pushed = 0;
+    while (stepGen->queued() < lead && stepGen->freeSlots() > 0 && pushed < feedLimit) {
+        stepGen->push(nextStepIntervalUs());
+        pushed++;
+    }
+    // running short on purpose (drain before a microstep switch, last pulses of an absolute
+    // move) is not an underrun
+    stepGenStreaming = (pushed < feedLimit);
+    return units;
+}
+
+uint32_t MotionController::collectEmitted(uint32_t nowMs) {
+#if MOTION_HALL_IRQ
+    // hall ISR latches pos + pendingEmitted(); keep the pair consistent
+    noInterrupts();
+#endif
+    const uint32_t n = stepGen->takeEmitted();
+    // queue is drained before every microstep switch, so n pulses are all at ustepShift
+    const long units = (long)(n << ustepShift);
+    st.pos += stepGenForward ? units : -units;
+#if MOTION_HALL_IRQ
+    interrupts();
+#endif
+    if (n > 0) {
+        safety.lastStepPulseMs = nowMs;
+        steppedSinceRest = true;
+    }
+    return n;
+}
+
+uint32_t MotionController::nextStepIntervalUs() {
+    if (!planner.active()) return stepIntervalUs << ustepShift;
+    // one pulse covers 1 << ustepShift planned (fine) steps; steps the planner already
+    // walked (plannerLeadSteps) go out at the last planned rate
+    const uint32_t n = 1u << ustepShift;
+    const uint32_t lead = (plannerLeadSteps < n) ? plannerLeadSteps : n;
+    plannerLeadSteps -= lead;
+    uint32_t us = (pulseIntervalUs >> ustepShift) * lead;
+    for (uint32_t i = lead; i < n; i++) us += planner.nextIntervalUs();
+    if (lead < n) st.currentSps = planner.currentSps();
+    return us;
+}
+
+// ---- microstep switching ----
+// DRV8825 MODE0..2 (MS1..MS3) for 1/1 .. 1/32.
+static void drv8825MsBits(uint8_t div, bool& m1, bool& m2, bool& m3) {
+    switch (div) {
+        case 1:  m1 = false; m2 = false; m3 = false; break;
+        case 2:  m1 = true;  m2 = false; m3 = false; break;
+        case 4:  m1 = false; m2 = true;  m3 = false; break;
+        case 8:  m1 = true;  m2 = true;  m3 = false; break;
+        case 16: m1 = false; m2 = false; m3 = true;  break;
+        default: m1 = true;  m2 = false; m3 = true;  break;   // 32
+    }
+}
+
+uint8_t MotionController::coarseShift() const {
+    uint8_t sh = 0;
+    while (sh < 5 && (uint32_t)(ustep.coarseDiv << sh) < ustep.fineDiv) sh++;
+    return sh;
+}
+
+uint8_t MotionController::desiredUstepShift(bool forward) const {
+    const uint8_t coarse = coarseShift();
+    if (!ustep.enabled || coarse == 0) return 0;
+
+    // near the ends: always fine (smooth approach, exact hall position)
+    if (st.travelSteps > 0) {
+        const long edge = forward ? (long)st.travelSteps - st.pos : st.pos;
+        if (edge <= (long)(kUstepEndWindowPulses << coarse)) return 0;
+    }
+    if (st.state == MotionState::ProgramMove) {
+        const long left = forward ? program.target - st.pos : st.pos - program.target;
+        if (left <= (long)(kUstepEndWindowPulses << coarse)) return 0;
+    }
+
+    // speed with hysteresis (both thresholds in fine steps/s)
+    if (ustepShift == 0) return (st.currentSps >= ustep.coarseAboveSps) ? coarse : 0;
+    return (st.currentSps <= ustep.fineBelowSps) ? 0 : coarse;
+}
+
+uint32_t MotionController::unitsToAlign(long pos, bool forward, uint32_t r) {
+    long m = pos % (long)r;
+    if (m < 0) m += (long)r;
+    if (m == 0) return 0;
+    return forward ? r - (uint32_t)m : (uint32_t)m;
+}
+
+void MotionController::applyUstepShift(uint8_t shift) {
+    if (!msWired) {
+        st.microstepDiv = MS_STRAP_DIV;   // strapped in hardware, never switched
+        return;
+    }
+    const uint8_t div = (uint8_t)(ustep.fineDiv >> shift);
+    bool m1, m2, m3;
+    drv8825MsBits(div ? div : 1, m1, m2, m3);
+    drv.setMicrostepPins(m1, m2, m3);
+
+    // polled: the pending pulse was planned at the old size. Keep the planner on st.pos:
+    // going fine, the steps it already walked are emitted first (plannerLeadSteps); going
+    // coarse, the pulse takes the missing steps from that lead, then from the planner.
+    const uint32_t oldUnits = 1u << ustepShift;
+    const uint32_t newUnits = 1u << shift;
+    if (!stepGen && planner.active()) {
+        if (newUnits < oldUnits) {
+            plannerLeadSteps += oldUnits - newUnits;
+        } else {
+            uint32_t need = newUnits - oldUnits;
+            const uint32_t lead = (plannerLeadSteps < need) ? plannerLeadSteps : need;
+            plannerLeadSteps -= lead;
+            for (need -= lead; need > 0; need--) planner.nextIntervalUs();
+        }
+    }
+    // rescale the pending pulse interval to the new pulse size
+    if (shift > ustepShift) pulseIntervalUs <<= (shift - ustepShift);
+    else pulseIntervalUs >>= (ustepShift - shift);
+    ustepShift = shift;
+    st.microstepDiv = div;
+    stepSchedValid = false;   // next polled pulse re-derives its interval
+}
+
+void MotionController::planStroke() {
+    // unknown travel (steps 0): rampSpeed() with v^2/2a braking
+    if (st.state == MotionState::MoveLeft) planZoned((long)st.travelSteps, 0);
+    else planZoned(0, (long)st.travelSteps);
+}
+
+void MotionController::planMove(uint32_t steps, uint32_t vCruise) {
+    MotionPlanner::Leg one;
+    one.steps = steps;
+    one.vCruise = vCruise;
+    planLegs(&one, 1);
+}
+
+void MotionController::planZoned(long from, long to) {
+    MotionPlanner::Leg legs[MotionPlanner::kMaxLegs];
+    planLegs(legs, zoneLegs(from, to, legs));
+}
+
+void MotionController::planLegs(const MotionPlanner::Leg* legs, uint8_t n) {
+    planner.clear();
+    plannerLeadSteps = 0;
+    stepSchedValid = false;
+
+    const uint32_t vMin = toInt(fx.minSps);
+    if (!planner.planLegs(legs, n, vMin, vMin, fx.accel, fx.jerk)) return;
+
+    st.currentSps = planner.segments().vStart;
+    pulseIntervalUs = planner.firstIntervalUs() << ustepShift;
+}
+
+static_assert(MotionPlanner::kMaxLegs >= 2 * kMotionZoneCount + 1,
+              "every zone edge can split the stroke");
+
+uint8_t MotionController::zoneLegs(long from, long to, MotionPlanner::Leg* legs) const {
+    const bool right = to >= from;
+    const long lo = right ? from : to;
+    const long hi = right ? to : from;
+    if (hi <= lo) return 0;
+
+    auto edge = [&](uint16_t permille) {
+        return (long)(((uint64_t)st.travelSteps * permille) / 1000u);
+    };
+
+    // cut points: the move's ends plus every zone edge strictly inside, ascending
+    long cut[2 + 2 * kMotionZoneCount];
+    uint8_t nc = 0;
+    cut[nc++] = lo;
+    for (uint8_t i = 0; i < kMotionZoneCount; i++) {
+        if (!fx.zoneSps[i]) continue;
+        const long a = edge(cfg.zones[i].fromPermille);
+        const long b = edge(cfg.zones[i].toPermille);
+        if (a > lo && a < hi) cut[nc++] = a;
+        if (b > lo && b < hi) cut[nc++] = b;
+    }
+    cut[nc++] = hi;
+    for (uint8_t i = 2; i + 1 < nc; i++) {
+        const long x = cut[i];
+        uint8_t j = i;
+        while (j > 1 && cut[j - 1] > x) { cut[j] = cut[j - 1]; j--; }
+        cut[j] = x;
+    }
+
+    // one leg per slice at the slowest zone covering it (maxSps outside); equal neighbours merge
+    uint8_t n = 0;
+    for (uint8_t c = 0; c + 1 < nc; c++) {
+        if (cut[c + 1] <= cut[c]) continue;   // shared edge
+        const long mid = cut[c] + (cut[c + 1] - cut[c]) / 2;
+        uint32_t v = toInt(fx.maxSps);
+        for (uint8_t i = 0; i < kMotionZoneCount; i++) {
+            if (!fx.zoneSps[i] || fx.zoneSps[i] >= v) continue;
+            if (mid >= edge(cfg.zones[i].fromPermille) && mid < edge(cfg.zones[i].toPermille)) v = fx.zoneSps[i];
+        }
+        const uint32_t len = (uint32_t)(cut[c + 1] - cut[c]);
+        if (n > 0 && legs[n - 1].vCruise == v) {
+            legs[n - 1].steps += len;
+        } else {
+            legs[n].steps = len;
+            legs[n].vCruise = v;
+            n++;
+        }
+    }
+
+    // leftward moves walk the slices from the right end
+    if (!right) {
+        for (uint8_t i = 0; i < n / 2; i++) {
+            const MotionPlanner::Leg t = legs[i];
+            legs[i] = legs[n - 1 - i];
+            legs[n - 1 - i] = t;
+        }
+    }
+    return n;
+}
+
+uint32_t MotionController::stopStepGen() {
+    planner.clear();
+    plannerLeadSteps = 0;
+    rampAccel = 0;
+    stepSchedValid = false;
+    stepGenStreaming = false;
+    uint32_t n = 0;
+    if (stepGen) {
+        stepGen->flush();
+        n = collectEmitted(millis()) << ustepShift;
+    }
+    // every stroke/homing pass starts fine; the queue is empty so this is safe here
+    if (ustepShift != 0) applyUstepShift(0);
+    return n;
 }
 
 bool MotionController::isMovingState(MotionState s) const {
     return (s == MotionState::HomingLeft || s == MotionState::CalibMoveRight ||
-            s == MotionState::MoveLeft  || s == MotionState::MoveRight);
+            s == MotionState::MoveLeft  || s == MotionState::MoveRight ||
+            s == MotionState::HomingSeek || s == MotionState::HomingBackoff ||
+            s == MotionState::Stopping || s == MotionState::ProgramMove);
+}
+
+long MotionController::takeEndHitPos(bool left, long fallback) {
+    long edge = fallback;
+#if MOTION_HALL_IRQ
+    HallInput& h = hallIn[left ? 0 : 1];
+    if (h.latched) {
+        edge = h.latchPos;
+        h.latched = false;
+    }
+#else
+    (void)left;
+#endif
+    const long over = (st.pos > edge) ? (st.pos - edge) : (edge - st.pos);
+    if ((uint32_t)over > st.hallOvershootMax) st.hallOvershootMax = (uint32_t)over;
+    return edge;
+}
+
+void MotionController::clearHallLatches() {
+#if MOTION_HALL_IRQ
+    hallIn[0].latched = false;
+    hallIn[1].latched = false;
+#endif
+}
+
+bool MotionController::checkPositionWindow(long err, bool hit) {
+    // forced moves run with travel 0; a warm start's first hit is judged by compensateDrift()
+    if (!posWindow.enabled || st.travelSteps == 0 || warm.verifying) return true;
+    if (!hit && err <= 0) return true;   // still short of the switch point
+
+    const uint32_t mag = (uint32_t)((err < 0) ? -err : err);
+    if (posWindow.faultSteps > 0 && mag > posWindow.faultSteps) {
+        st.posWindowErrLast = err;
+        fault(MotionError::PositionWindow);
+        return false;
+    }
+    if (mag > posWindow.warnSteps && !posWindow.warned) {
+        posWindow.warned = true;
+        st.posWindowWarns++;
+        st.posWindowErrLast = err;
+    }
+    return true;
 }
 
+void MotionController::compensateDrift(bool left, long edgePos) {
+    const bool verify = warm.verifying;   // first hit after a warm start is always checked
+    warm.verifying = false;
+    if ((!drift.enabled && !verify) || st.travelSteps == 0) return;   // forced moves / travel unknown
+
+    const long expected = left ? 0 : (long)st.travelSteps;
+    const long d = edgePos - expected;
+    const uint32_t mag = (uint32_t)((d < 0) ? -d : d);
+    st.driftLast = d;
+    if (mag > st.driftMaxAbs) st.driftMaxAbs = mag;
+
+    if (mag > drift.rehomeAboveSteps) {
+        drift.rehomePending = true;   // too far off to trust: rehome after this dwell
+        if (verify) st.warmRejects++;
+        return;
+    }
+    if (verify) st.warmStarts++;
+    if (d != 0) {
+        // the switch point is the reference: shift pos so it lands where expected
+        st.pos -= d;
+        st.driftCorrections++;
+    }
+}
+
+#if MOTION_HALL_IRQ
+void MotionController::hallIsrLeft(void* self) {
+    static_cast<MotionController*>(self)->onHallEdge(true);
+}
+
+void MotionController::hallIsrRight(void* self) {
+    static_cast<MotionController*>(self)->onHallEdge(false);
+}
+
+void MotionController::onHallEdge(bool left) {
+    // ISR: timestamp + position only, all filtering happens in tick()
+    HallEdge e;
+    e.us = micros();
+    const int raw = digitalRead(left ? pins.hallLeft : pins.hallRight);
+    e.left = left ? 1 : 0;
+    e.active = (HALL_ACTIVE_LOW ? (raw == LOW) : (raw == HIGH)) ? 1 : 0;
+    long pos = st.pos;
+    if (stepGen) {
+        // pulses already on the STEP pin but not yet collected into st.pos
+        const long n = (long)(stepGen->pendingEmitted() << ustepShift);
+        pos += stepGenForward ? n : -n;
+    }
+    e.pos = pos;
+    if (!hallQ.push(e)) hallQOverflow = true;
+}
+
+void MotionController::resyncHallInputs() {
+    hallQ.clear();
+    hallQOverflow = false;
+    for (uint8_t i = 0; i < 2; i++) {
+        const int raw = digitalRead(i == 0 ? pins.hallLeft : pins.hallRight);
+        hallIn[i].level = HALL_ACTIVE_LOW ? (raw == LOW) : (raw == HIGH);
+        hallIn[i].pending = false;
+        hallIn[i].latched = false;
+    }
+}
+
+void MotionController::drainHallEdges(uint32_t nowUs) {
+    // Lost edges: trust the pins again (no exact position for this one).
+    if (hallQOverflow) resyncHallInputs();
+
+    auto confirm = [&](HallInput& h) {
+        h.level = h.cand.active != 0;
+        h.pending = false;
+        h.latched = h.level;
+        h.latchPos = h.cand.pos;
+        const uint32_t react = nowUs - h.cand.us;
+        if (react > st.hallReactMaxUs) st.hallReactMaxUs = react;
+    };
+
+    HallEdge e;
+    while (hallQ.pop(e)) {
+        HallInput& h = hallIn[e.left ? 0 : 1];
+        const bool act = e.active != 0;
+        if (h.pending) {
+            if (act == (h.cand.active != 0)) continue;   // repeated level, same edge
+            if ((uint32_t)(e.us - h.cand.us) < hallGlitchUs) {
+                // flipped back inside the window: drop the pair
+                h.pending = false;
+                st.hallGlitches++;
+                continue;
+            }
+            confirm(h);
+        }
+        if (act != h.level) {
+            h.cand = e;
+            h.pending = true;
+        }
+    }
+
+    for (uint8_t i = 0; i < 2; i++) {
+        HallInput& h = hallIn[i];
+        if (h.pending && (uint32_t)(nowUs - h.cand.us) >= hallGlitchUs) confirm(h);
+    }
+}
+#endif
+
 void MotionController::updateHallHealth(uint32_t nowMs) {
     // Track rising edges (inactive->active) for each hall; counts as "end hit".
     if (st.hallL && !safety.lastHallL) safety.lastEndHitMs = nowMs;
@@ -715,13 +2122,14 @@ void MotionController::applyLedAndMotorPolicy(bool ledShouldBeOn) {
     }
 
     // LED is the "truth"; motor follows.
-    digitalWrite(PIN_GROW_LED, ledShouldBeOn ? HIGH : LOW);
+    if (pins.growLed != 255) digitalWrite(pins.growLed, ledShouldBeOn ? HIGH : LOW);
     led.lastAppliedOn = ledShouldBeOn;
 
-    if (!ledShouldBeOn) {
+    // a controlled stop keeps the driver until it has decelerated (bounded by stopping.timeoutMs)
+    if (!ledShouldBeOn && st.state != MotionState::Stopping) {
         drv.enable(false);
-        st.targetSps = 0;
-        st.currentSps = 0;
+        setTarget(0);
+        setSpeed(0);
     }
 }
 
@@ -729,43 +2137,107 @@ uint32_t MotionController::deriveNoEndTimeoutMs() const {
     // Conservative: expected travel time at min speed + dwell + margin.
     uint32_t steps = st.travelSteps;
     if (steps == 0) steps = 20000; // unknown travel; choose conservative large default
-    float t = (float)steps / maxf(cfg.minSps, 1.0f);
-    uint32_t travelMs = (uint32_t)(t * 1000.0f) + 5000;
-    return travelMs + cfg.dwellMs + 2000;
+    const uint32_t moveMs = travelMs(steps, fx.minSpsInt) + 5000;
+    return moveMs + cfg.dwellMs + 2000;
 }
 
 void MotionController::rampSpeed(uint32_t nowMs, bool useDecel) {
     uint32_t dtMs = nowMs - lastRampMs;
     if (dtMs == 0) return;
     lastRampMs = nowMs;
+    if (dtMs > 1000) dtMs = 1000;   // keep dv in range after a long stall
 
-    float dt = (float)dtMs / 1000.0f;
-    float v = st.currentSps;
-    float vmax = cfg.maxSps;
-    float vmin = cfg.minSps;
-    float a = maxf(cfg.accel, 1.0f);
+    q16 v = speedQ;
+    const q16 vmax = fx.maxSps;
+    const q16 vmin = fx.minSps;
+    const q16 dv = fx.accelPerMs * dtMs;
 
-    float desired = st.targetSps;
+    q16 desired = targetQ;
 
     if (useDecel && st.travelSteps > 0) {
-        uint32_t traveled = moveSteps;
+        uint32_t traveled = moveSteps + (stepGen ? (stepGen->queued() << ustepShift) : 0);
         if (traveled > st.travelSteps) traveled = st.travelSteps;
         uint32_t remaining = st.travelSteps - traveled;
 
-        float brake = (v * v) / (2.0f * a);
-        if ((float)remaining <= brake) desired = vmin;
+        if (remaining <= brakeSteps(v, fx.accel)) desired = vmin;
         else desired = vmax;
     }
 
-    if (v < desired) {
-        v += a * dt;
-        if (v > desired) v = desired;
+    if (fx.jerk) {
+        rampJerkLimited(v, desired, dtMs);
+    } else if (v < desired) {
+        v = (desired - v > dv) ? v + dv : desired;
     } else if (v > desired) {
-        v -= a * dt;
-        if (v < desired) v = desired;
+        v = (v - desired > dv) ? v - dv : desired;
     }
 
     if (v < vmin) v = vmin;
     if (v > vmax) v = vmax;
-    st.currentSps = v;
-}
\ No newline at end of file
+    setSpeed(v);
+}
+
+void MotionController::rampJerkLimited(q16& v, q16 desired, uint32_t dtMs) {
+    // S-curve for unplanned moves (homing/calibration/forced): accel slews at `jerk`
+    // and is capped at sqrt(2*j*gap) so it has tapered to ~0 when v reaches desired.
+    if (v == desired) { rampAccel = 0; return; }
+
+    const bool up = v < desired;
+    const uint32_t gap = toInt(up ? desired - v : v - desired);
+    uint32_t aLim = fx.accel;
+    // 64-bit: accel^2 overflows 32 bits above 65535 steps/s^2
+    const uint64_t twoJGap = 2ull * fx.jerk * gap;
+    if (twoJGap < (uint64_t)fx.accel * fx.accel) aLim = isqrt64(twoJGap);
+    if (aLim == 0) aLim = 1;
+
+    const int32_t aTarget = up ? (int32_t)aLim : -(int32_t)aLim;
+    const uint32_t slew = (fx.jerk / 1000u) * dtMs + 1;
+    if (rampAccel < aTarget) rampAccel = ((uint32_t)(aTarget - rampAccel) > slew) ? rampAccel + (int32_t)slew : aTarget;
+    else if (rampAccel > aTarget) rampAccel = ((uint32_t)(rampAccel - aTarget) > slew) ? rampAccel - (int32_t)slew : aTarget;
+
+    const uint32_t aAbs = (uint32_t)(rampAccel < 0 ? -rampAccel : rampAccel);
+    const q16 dv = accelPerMs(fromInt(aAbs)) * dtMs;
+    if (rampAccel > 0)      v = (up && desired - v <= dv) ? desired : v + dv;
+    else if (rampAccel < 0) v = (!up && v - desired <= dv) ? desired : (v > dv ? v - dv : 0);
+    if (v == desired) rampAccel = 0;
+}
+
+void MotionController::applyFixedConfig() {
+    markConfigChanged();
+    fx.maxSps = toQ16(cfg.maxSps);
+    fx.minSps = toQ16(cfg.minSps);
+    const q16 a = toQ16(cfg.accel);
+    fx.accel = toInt(a) ? toInt(a) : 1;
+    fx.accelPerMs = accelPerMs(a ? a : fromInt(1));
+    fx.minSpsInt = toInt(fx.minSps) ? toInt(fx.minSps) : 1;
+
+    fx.jerk = 0;
+    if (cfg.profile == MotionProfile::SCurve) {
+        float j = cfg.jerk;
+        if (!(j >= 1000.0f)) j = 1000.0f;
+        if (j > 2000000.0f) j = 2000000.0f;
+        fx.jerk = (uint32_t)j;
+    }
+
+    const uint32_t maxInt = toInt(fx.maxSps);
+    for (uint8_t i = 0; i < kMotionZoneCount; i++) {
+        const MotionZone& z = cfg.zones[i];
+        uint32_t v = 0;
+        if (z.toPermille > z.fromPermille && z.sps > 0.0f) {
+            v = toInt(toQ16(z.sps));
+            if (v > maxInt) v = maxInt;
+            if (v < fx.minSpsInt) v = fx.minSpsInt;
+        }
+        fx.zoneSps[i] = v;
+    }
+}
+
+void MotionController::setSpeed(q16 sps) {
+    speedQ = sps;
+    st.currentSps = toInt(sps);
+    stepIntervalUs = intervalUs(sps);
+}
+
+void MotionController::setTarget(q16 sps) {
+    targetQ = sps;
+    st.targetSps = toInt(sps);
+}
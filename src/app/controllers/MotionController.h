@@ -2,7 +2,18 @@
 #include <Arduino.h>
 #include "../../config/Defaults.h"
 #include "../../config/PinMap.h"
+#include "../../config/Features.h"
+#include "../../platform/util/SpscRing.h"
+#include "../../platform/util/SeqLock.h"
+#if MOTION_STEPPER_SIO
+#include "../../hal/StepperHal_Sio.h"
+#else
 #include "../../hal/StepperHal_Drv8825.h"
+#endif
+#include "../../hal/StepGenHal.h"
+#include "MotionMath.h"
+#include "MotionPlanner.h"
+#include "AutoTuneSearch.h"
 
 enum class MotionState : uint8_t {
     HomingLeft = 0,
@@ -12,7 +23,12 @@ enum class MotionState : uint8_t {
     Dwell = 4,
     Fault = 5,
     RecoverWait = 6,
-    Stopped = 7
+    Stopped = 7,
+    HomingSeek = 8,      // two-stage homing: fast search for the left hall
+    HomingBackoff = 9,   // back off the hall, then HomingLeft re-approaches slowly
+    Stopping = 10,       // controlled stop: decelerating to minSps, then Stopped with pos kept
+    ProgramMove = 11,    // motion program: planned move to an absolute position
+    ProgramHold = 12     // motion program: holding position (driver enabled)
 };
 
 enum class MotionError : uint8_t {
@@ -21,7 +37,8 @@ enum class MotionError : uint8_t {
     TravelTimeout = 2,
     CalibFailed = 3,
     BothLimitsActive = 4,
-    MotionStall = 5
+    MotionStall = 5,
+    PositionWindow = 6   // hall missing past (or far ahead of) the learned travel
 };
 
 enum class LedMode : uint8_t {
@@ -29,12 +46,34 @@ enum class LedMode : uint8_t {
     Manual = 1
 };
 
+// Hall edge latched in the GPIO ISR (MOTION_HALL_IRQ).
+struct HallEdge {
+    uint32_t us = 0;      // micros() at the edge
+    long pos = 0;         // step position at the edge (generator pulses not yet collected included)
+    uint8_t left = 0;     // 1 = left sensor, 0 = right
+    uint8_t active = 0;   // level after the edge, HALL_ACTIVE_LOW already applied
+};
+
+// One entry of the motion program queue (MotionController::requestProgram*()).
+struct MotionProgramStep {
+    enum class Op : uint8_t { MoveTo, Hold, Sweep };
+    Op op = Op::MoveTo;
+    bool fraction = false;   // a/b in permille of travelSteps (resolved when the step starts)
+    uint8_t count = 0;       // Sweep: round trips a -> b -> a after reaching a
+    long a = 0;              // MoveTo/Sweep position (fine steps); Hold: ms
+    long b = 0;
+    uint32_t sps = 0;        // cruise speed, 0 = maxSps through the speed map
+};
+
 struct MotionStatus {
     MotionState state = MotionState::HomingLeft;
     MotionError err = MotionError::None;
-    float currentSps = 0;
-    float targetSps = 0;
+    uint32_t currentSps = 0;   // steps/s (integer view of the Q16 speed)
+    uint32_t targetSps = 0;
     long pos = 0;
+    // pos is referenced to the left switch point (set by homing, kept through Dwell and
+    // stops at rest, lost when a moving stroke is cut or faults).
+    bool posValid = false;
     bool hallL = false;
     bool hallR = false;
 
@@ -42,8 +81,74 @@ struct MotionStatus {
     uint8_t hallRawL = 0;
     uint8_t hallRawR = 0;
 
+    // Hall edge capture (MOTION_HALL_IRQ): edges rejected by the glitch filter, worst
+    // edge -> tick reaction time (us), worst stop overshoot past the switch point (steps).
+    uint32_t hallGlitches = 0;
+    uint32_t hallReactMaxUs = 0;
+    uint32_t hallOvershootMax = 0;
+
+    // Travel drift (steps): switch point seen at an end hit minus where pos expected it
+    // (0 at left, travelSteps at right). Within the limit pos is re-aligned; beyond it a
+    // full rehome runs. rehomesAvoided counts periodic rehomes skipped, rehomeMsLast the
+    // duration of the last homing + calibration (throughput cost of one rehome).
+    long driftLast = 0;
+    uint32_t driftMaxAbs = 0;
+    uint32_t driftCorrections = 0;
+    uint32_t driftRehomes = 0;
+    uint32_t rehomesAvoided = 0;
+    uint32_t rehomeMsLast = 0;
+    // Warm starts (learned travel/park position reused) confirmed by the first end hit,
+    // and ones rejected there (full rehome followed).
+    uint32_t warmStarts = 0;
+    uint32_t warmRejects = 0;
+    // Expected-hall window (travel known): strokes that ran past the warn limit without
+    // the hall, or hit it that far early; last such error in steps (+ late, - early).
+    uint32_t posWindowWarns = 0;
+    long posWindowErrLast = 0;
+    // Motion program: steps waiting (the running one included), adds/runs refused
+    // (queue full, not homed, program already running).
+    uint8_t programQueued = 0;
+    uint32_t programRejects = 0;
+    // Auto tune: stage being run, then the outcome of the last search (autoTuneSeq bumps
+    // once per finished search). autoTuneLostLast = switch-point error that failed a stage.
+    bool autoTuneRunning = false;
+    uint8_t autoTuneStage = 0;
+    uint32_t autoTuneSeq = 0;
+    AutoTuneResult autoTuneResult = AutoTuneResult::None;
+    uint8_t autoTuneStagesPassed = 0;
+    uint32_t autoTuneSps = 0;
+    uint32_t autoTuneAccel = 0;
+    long autoTuneLostLast = 0;
+
     uint32_t travelSteps = 0;
     uint32_t cycles = 0;
+
+    // Worst step-interval error (us): actual pulse time vs. the commanded interval.
+    // Polled mode measures loop latency; generator backends report their own lateness.
+    uint32_t stepLateMaxUs = 0;
+    // Schedule overruns: polled steps that missed at least one whole slot, or generator
+    // queue underruns. stepCatchUp = steps emitted while behind schedule (polled),
+    // stepDropped = backlog steps beyond the catch-up burst limit (really lost).
+    uint32_t stepOverruns = 0;
+    uint32_t stepCatchUp = 0;
+    uint32_t stepDropped = 0;
+    // Step-interval jitter (polled steps): |actual - commanded| inter-step interval per log2
+    // bin (bin 0 < 8 us, bin i [2^(i+2), 2^(i+3)) us, last bin open; saturating). Worst =
+    // largest signed deviation (+ late) with its commanded interval, state and uptime.
+    // stepLostUs / stepRecoveredUs = total time steps went out later / earlier (catch-up)
+    // than commanded. Generator backends time pulses in hardware and leave these at 0.
+    static constexpr uint8_t kStepJitterBins = 12;
+    uint16_t stepJitterHist[kStepJitterBins] = {0};
+    uint32_t stepJitterSamples = 0;
+    int32_t stepJitterWorstUs = 0;
+    uint32_t stepJitterWorstCmdUs = 0;
+    MotionState stepJitterWorstState = MotionState::Stopped;
+    uint32_t stepJitterWorstMs = 0;
+    uint32_t stepLostUs = 0;
+    uint32_t stepRecoveredUs = 0;
+    // Active DRV8825 microstep resolution (1/N). pos/travelSteps/speeds are always
+    // counted in the fine resolution, so they don't change when this switches.
+    uint8_t microstepDiv = 1;
     uint8_t recoverAttempts = 0;
 
     MotionError lastErr = MotionError::None;
@@ -90,12 +195,64 @@ struct MotionStatus {
     uint32_t factoryLogCycles[8] = {0};
 };
 
+// Small, frequently polled subset of MotionStatus. Published every tick (cheap to copy),
+// so loop-rate readers (serial log, BedLink telemetry) don't need the full ~300 B snapshot.
+struct MotionHotStatus {
+    MotionState state = MotionState::HomingLeft;
+    MotionError err = MotionError::None;
+    bool hallL = false;
+    bool hallR = false;
+    bool ledOn = false;
+    uint32_t currentSps = 0;
+    long pos = 0;
+    uint32_t travelSteps = 0;
+    uint32_t cycles = 0;
+};
+
+// core0 -> motion core request. Every runtime mutator enqueues one of these and
+// tick() applies them in order, so all MotionController state is owned by one core.
+struct MotionCommand {
+    enum class Type : uint8_t {
+        Start, Stop, Home, Recalibrate, ForceMoveLeft, ForceMoveRight, InjectFault,
+        SetMaxSps, SetAccel, SetDwell, SetRehome, SetProfile, SetJerk,
+        SetReversal, SetSettle, SetZone,
+        LedAuto, LedManual, LedSchedule, Clock, AckAlert, UiMute,
+        SimHallLeft, SimHallRight, FactoryStart, FactoryStop, FactoryResult,
+        StallPulseTimeout, StallNoEndTimeout, ResetStepTiming, StepCatchUp,
+        StepMicrostep, HallGlitch, DriftComp, HomingMode, PosWindow,
+        ProgramAdd, ProgramClear, ProgramRun, AutoTuneStart, AutoTuneStop
+    };
+    Type type = Type::Stop;
+    uint8_t b0 = 0, b1 = 0, b2 = 0;
+    uint32_t u0 = 0, u1 = 0;
+    float f = 0;
+};
+
+// motion core -> core0 notification; callbacks run from pollEvents() on core0.
+struct MotionEvent {
+    enum class Type : uint8_t { Alert, Factory, AutoTune };
+    Type type = Type::Alert;
+    bool pass = false;
+    uint8_t code = 0;       // alert code / factory failCode / AutoTuneResult
+    uint8_t failStep = 0;   // factory failStep / auto tune stages passed
+    uint32_t seq = 0;
+    uint32_t durationMs = 0;
+    uint32_t uptimeMs = 0;
+    uint32_t cycles = 0;
+    uint32_t sps = 0;       // auto tune: committed maxSps / accel
+    uint32_t accel = 0;
+};
+
 class MotionController {
 public:
     // Alert callback (e.g., send to LineBed). Called at fault time.
-    using AlertCallback = void(*)(uint8_t code, uint32_t seq, uint32_t uptimeMs, uint32_t cycles);
-    using FactoryCallback = void(*)(uint32_t seq, bool pass, uint8_t failCode, uint8_t failStep,
-                                    uint32_t durationMs, uint32_t uptimeMs, uint32_t cycles);
+    using AlertCallback = void(*)(uint8_t channel, uint8_t code, uint32_t seq, uint32_t uptimeMs,
+                                  uint32_t cycles);
+    using FactoryCallback = void(*)(uint8_t channel, uint32_t seq, bool pass, uint8_t failCode,
+                                    uint8_t failStep, uint32_t durationMs, uint32_t uptimeMs,
+                                    uint32_t cycles);
+    using AutoTuneCallback = void(*)(uint8_t channel, uint32_t seq, AutoTuneResult result,
+                                     uint8_t stagesPassed, uint32_t maxSps, uint32_t accel);
 
 public:
     // UI/Test can temporarily mute popups/alerts while running scripted validation.
@@ -103,8 +260,22 @@ public:
     void setUiMuteSeconds(uint16_t seconds);
     bool isUiMuteActive() const;
 
+    // Bed channel index and its pins (driver, halls, grow LED). Must be set before begin();
+    // defaults to channel 0 on the PinMap.h pins.
+    void setChannel(uint8_t index, const MotionPins& pins);
+    uint8_t channel() const { return channelIdx; }
+
+    // Optional hardware step generator (PIO etc.). Must be attached before begin().
+    // Without one, STEP is bit-banged from tick() (polled mode).
+    void attachStepGenerator(StepGenHal* gen);
+
     void begin(const MotionConfig& cfg_);
 
+    // Restore learned travel and the parked position (call before begin()). Ignored when the
+    // steps were counted at another microstep. begin()/requestStart() then skip calibration
+    // and verify at the first end hit instead.
+    void applyPersistedMotion(uint32_t travelSteps, long parkPos, bool parkValid, uint8_t microstepDiv);
+
     // Restore alert ring buffer from persisted storage.
     void applyPersistedAlerts(uint32_t seq, uint8_t head, uint8_t count,
                               const uint8_t* codes, const uint32_t* uptimeSec);
@@ -122,25 +293,72 @@ public:
 
     void setAlertCallback(AlertCallback cb);
     void setFactoryCallback(FactoryCallback cb);
+    void setAutoTuneCallback(AutoTuneCallback cb);
 
     // UI can call this after showing a popup.
     void acknowledgeAlert(uint32_t seq);
 
+    // Setup-time only (before tick() starts running).
     void applyConfig(const MotionConfig& cfg_);
 
+    // With MOTION_ON_CORE1 these return the core0 view refreshed by pollEvents():
+    // a consistent snapshot that stays stable until the next pollEvents().
     const MotionConfig& config() const;
     const MotionStatus& status() const;
 
+    // Lock-free consistent reads straight from the publisher (any core, not from ISRs).
+    void copyStatus(MotionStatus& out) const;
+    MotionHotStatus hotStatus() const;
+
+    // core0: refresh the status/config view and run queued alert/factory callbacks.
+    // Call once per loop() before anything reads status().
+    void pollEvents();
+    uint32_t commandsDropped() const { return cmdDropped; }
+#if MOTION_ON_CORE1
+    // core0 setup(), after the applyPersisted*() calls and before core1 is released:
+    // publishes the restored status and boot config, so core0 readers never see the
+    // default-constructed snapshot while core1 is still in begin().
+    void publishBootStatus(const MotionConfig& bootCfg);
+#endif
+
     // ---- LED policy / Motor enable linkage ----
     void setLedModeAuto();
     void setLedModeManual(bool on);
     void setLedScheduleMinutes(uint16_t onStartMin, uint16_t onEndMin);
     void setClockMinutes(uint16_t minutesSinceMidnight);
 
+    // Step timing measurement (see MotionStatus::stepLateMaxUs)
+    void resetStepTimingStats();
+
     // Safety timeouts (can be tuned from UI/engineering later)
     void setMotionStallPulseTimeoutMs(uint32_t ms);
     void setMotionStallNoEndTimeoutMs(uint32_t ms);
 
+    // Polled-mode step catch-up (see CatchUpPolicy).
+    void setStepCatchUp(bool enabled, uint8_t maxBurstSteps, uint16_t capPercent);
+
+    // Automatic microstep switching (see MicrostepPolicy). Divisors are powers of two
+    // (1..32); thresholds are in fine steps/s. fineDiv defines the step unit of pos,
+    // travelSteps and MotionConfig speeds, so changing it needs a recalibrate. Without
+    // MS pins this is a no-op and the unit is the strapped MS_STRAP_DIV.
+    void setMicrostepPolicy(bool enabled, uint8_t fineDiv, uint8_t coarseDiv,
+                            uint32_t coarseAboveSps, uint32_t fineBelowSps);
+
+    // Hall edges that flip back within `us` are dropped as glitches; an edge is acted on
+    // once the level has held that long. 0 = act on every edge.
+    void setHallGlitchFilterUs(uint32_t us);
+
+    // Travel drift compensation (see DriftPolicy). Enabled: the periodic rehome
+    // (cfg.rehomeEveryCycles) is replaced by a rehome only when |drift| > rehomeAboveSteps.
+    void setDriftCompensation(bool enabled, uint32_t rehomeAboveSteps);
+
+    // Homing (see HomingPolicy). twoStage=false: single HomingLeft pass at minSps.
+    void setHomingPolicy(bool twoStage, uint16_t blindSeekPercent, uint32_t backoffSteps);
+
+    // Step-count stall check (see PositionWindowPolicy), in fine steps around the
+    // expected switch point. faultSteps 0 = warn only.
+    void setPositionWindow(bool enabled, uint32_t warnSteps, uint32_t faultSteps);
+
     // ---- UI-facing request API (non-blocking) ----
     void requestStart();
     void requestStop();
@@ -155,12 +373,38 @@ public:
     void requestSetAccel(float a);
     void requestSetDwell(uint32_t ms);
     void requestSetRehomeEvery(uint32_t cycles);
+    void requestSetProfile(MotionProfile p);
+    void requestSetJerk(float j);
+    void requestSetReversal(ReversalMode m);
+    void requestSetReverseSettle(uint32_t ms);
+    // Speed map slot (0..kMotionZoneCount-1) over [from, to) permille of the travel;
+    // from >= to clears it. Applies from the next stroke.
+    void requestSetZone(uint8_t index, uint16_t fromPermille, uint16_t toPermille, float sps);
+
+    // ---- Motion program (absolute moves from a small queue) ----
+    // Positions are fine steps from the left switch point, or permille of travelSteps for
+    // the fraction variants. sps 0 cruises at maxSps through the speed map. Run needs a
+    // homed bed: from rest it starts at once, a running stroke ramps down first. Steps are
+    // dropped as they complete; a stop/fault keeps the rest queued for the next Run, and
+    // the end of the program parks in Stopped with pos kept (requestStart() resumes).
+    void requestProgramClear();
+    void requestProgramMoveTo(long pos, float sps = 0);
+    void requestProgramMoveToFraction(uint16_t permille, float sps = 0);
+    void requestProgramHold(uint32_t ms);
+    void requestProgramSweep(long a, long b, uint8_t count, bool fraction = false, float sps = 0);
+    void requestProgramRun();
 
     // ---- Test hooks (UI/Test menu) ----
     void requestSimulateHallLeft(uint16_t activeMs);
     void requestSimulateHallRight(uint16_t activeMs);
 
+    // Motion core: apply queued commands, run the FSM, publish status.
     void tick();
+    // Motion core: ms until tick() has work again (0 = keep ticking: moving, commands or
+    // hall edges waiting). Idle states report their next timer (dwell end, fault recovery,
+    // hold end), capped at kIdleWakeMaxMs so polled inputs are still sampled.
+    static constexpr uint32_t kIdleWakeMaxMs = 50;
+    uint32_t msUntilNextTick() const;
 
     // ---- Factory Auto Validation (default 10 cycles) ----
     void startFactoryAutoTest(uint32_t hallIntervalMs = 5000, uint16_t targetCycles = 10);
@@ -170,7 +414,31 @@ public:
     uint16_t factoryAutoTargetCycles() const;
     uint16_t factoryAutoStartCycles() const;
 
+    // ---- Auto tune (engineering): search the fastest maxSps/accel that keeps the margin ----
+    // Needs learned travel; starts the bed if stopped. The result lands in config() and
+    // status().autoTune*, and the AutoTune callback fires (persist/report from there).
+    void startAutoTune(const MotionAutoTunePolicy& policy = MotionAutoTunePolicy{});
+    void stopAutoTune();
+
 private:
+    void enqueue(const MotionCommand& c);
+    // false = stop draining and end this tick (fault injected)
+    bool applyCommand(const MotionCommand& c);
+    void tickMotion();
+    void publishStatus(uint32_t nowUs);
+    static MotionHotStatus makeHot(const MotionStatus& s);
+    void emitAlert(uint8_t code, uint32_t seq, uint32_t uptimeMs, uint32_t cycles);
+
+    // internal (motion core) forms of the public request API
+    void startFactoryAutoTestNow(uint32_t hallIntervalMs, uint16_t targetCycles);
+    void startAutoTuneNow(const MotionAutoTunePolicy& policy);
+    // Judge one end hit of the running stage (err = switch point - expected).
+    void autoTuneEndHit(long err);
+    void finishAutoTune(AutoTuneResult result);
+    void recordFactoryResultNow(bool pass, uint8_t failCode, uint8_t failStep, uint32_t durationMs, uint32_t uptimeMs);
+    void simulateHall(bool left, uint16_t activeMs);
+    void startIfStopped();
+
     // ---- internal sync helpers ----
     void syncAlertStatus();
     void syncFactoryStatus();
@@ -178,20 +446,88 @@ private:
                         uint32_t durationMs, uint32_t uptimeMs, uint32_t cycles);
 
     // ---- internal helpers ----
-    static float maxf(float a, float b);
+    // cfg changed: recompute the fixed-point copy and mark it for publication.
+    void applyFixedConfig();
+    // cfg field with no fixed-point copy changed (dwell, rehome, settle): publish only.
+    void markConfigChanged() {
+#if MOTION_ON_CORE1
+        cfgChanged = true;
+#endif
+    }
+    void setSpeed(motion_math::q16 sps);
+    void setTarget(motion_math::q16 sps);
 
     void resetForHoming(bool userInitiated);
+    // Start from rest: resume from a valid position, or home and reuse the learned travel;
+    // falls back to resetForHoming() when nothing was learned.
+    void startFromRest(bool userInitiated);
+    // Decelerate the current move to minSps before stopping so pos stays valid.
+    void beginControlledStop(uint32_t nowMs);
+    void tickStopping(uint32_t nowMs, uint32_t nowUs);
     void enterStopped(uint32_t nowMs);
     void fault(MotionError e);
 
     void enterDwell(uint32_t nowMs, MotionState next);
+    // Dwell exit: periodic/drift rehome check, then start the next stroke.
+    void leaveDwell(uint32_t nowMs, uint32_t nowUs);
+    uint32_t dwellTimeMs() const;   // dwellMs, or reverseSettleMs in Continuous reversal
     void enterForcedMove(bool toRight);
+    // Motion program execution (see ProgramQueue).
+    bool startProgram(uint32_t nowMs, uint32_t nowUs);
+    void programNext(uint32_t nowMs, uint32_t nowUs);
+    void programAdvance();
+    void beginProgramMove(long target, uint32_t sps, uint32_t nowMs, uint32_t nowUs);
+    void tickProgramMove(uint32_t nowMs, uint32_t nowUs);
+    long programPos(long v, bool fraction) const;
 
     bool stepDue(uint32_t nowUs);
     void doStep(bool forward, uint32_t nowMs, uint32_t nowUs);
+    void recordStepJitter(uint32_t actualUs, uint32_t commandedUs, uint32_t nowMs);
+    // Advance the step stream for this tick; returns steps actually emitted.
+    uint32_t runSteps(bool forward, uint32_t nowMs, uint32_t nowUs);
+    uint32_t collectEmitted(uint32_t nowMs);
+    // Interval after the step being emitted now: planner if a stroke plan is active, else ramp speed.
+    uint32_t nextStepIntervalUs();
+    // Position window check for a Move stroke: err = steps past the expected switch point
+    // (negative = short of it), hit = the hall switched. Returns false if it faulted.
+    bool checkPositionWindow(long err, bool hit);
+    // Plan the stroke that starts now (Dwell -> MoveLeft/MoveRight) when travel is known.
+    void planStroke();
+    // Plan `steps` from minSps up to vCruise and back down to minSps (then crawl).
+    void planMove(uint32_t steps, uint32_t vCruise);
+    // Plan from pos `from` to pos `to` through the speed map (one leg per zone crossed).
+    void planZoned(long from, long to);
+    void planLegs(const MotionPlanner::Leg* legs, uint8_t n);
+    uint8_t zoneLegs(long from, long to, MotionPlanner::Leg* legs) const;
+    // Left hall reached at approach speed: set the zero and start calibration.
+    void finishHoming(uint32_t nowMs, uint32_t nowUs);
+    uint32_t stopStepGen();
+
+    // Microstep switching. ustepShift = log2(fineDiv / activeDiv); one pulse = 1 << ustepShift units.
+    // Without MS pins the step unit is the strapped microstep (MS_STRAP_DIV).
+    uint8_t fineMicrostepDiv() const { return msWired ? ustep.fineDiv : (uint8_t)MS_STRAP_DIV; }
+    uint8_t coarseShift() const;
+    uint8_t desiredUstepShift(bool forward) const;
+    void applyUstepShift(uint8_t shift);
+    static uint32_t unitsToAlign(long pos, bool forward, uint32_t r);
+
     bool isMovingState(MotionState s) const;
 
     void updateHallHealth(uint32_t nowMs);
+    // Position where `left` last turned active (exact edge with MOTION_HALL_IRQ), or
+    // `fallback` if no edge was latched. Records the stop overshoot past that point.
+    long takeEndHitPos(bool left, long fallback);
+    // Drop edges latched before a new homing pass / move (their pos is in the old frame).
+    void clearHallLatches();
+    // Compare the end-hit switch point with the learned travel; re-align pos or flag a rehome.
+    void compensateDrift(bool left, long edgePos);
+#if MOTION_HALL_IRQ
+    static void hallIsrLeft(void* self);
+    static void hallIsrRight(void* self);
+    void onHallEdge(bool left);
+    void drainHallEdges(uint32_t nowUs);
+    void resyncHallInputs();
+#endif
 
     bool evalLedShouldBeOn() const;
     void applyLedAndMotorPolicy(bool ledShouldBeOn);
@@ -199,6 +535,7 @@ private:
     uint32_t deriveNoEndTimeoutMs() const;
 
     void rampSpeed(uint32_t nowMs, bool useDecel);
+    void rampJerkLimited(motion_math::q16& v, motion_math::q16 desired, uint32_t dtMs);
 
     // ---- Auto Hall Toggle test (no real sensors needed) ----
     void setAutoHallTest(bool enabled);
@@ -209,9 +546,43 @@ private:
 
 private:
     MotionConfig cfg;
-    StepperHal_Drv8825 drv;
+    uint8_t channelIdx = 0;
+    MotionPins pins = kMotionPins[0];
+#if MOTION_STEPPER_SIO && MOTION_CHANNELS == 1
+    StepperHal_Sio<> drv;                                // PinMap pins fold to immediates
+#elif MOTION_STEPPER_SIO
+    StepperHal_Sio<MotionPins> drv{kMotionPins[0]};     // per-channel pins at runtime
+#else
+    StepperHal_Drv8825 drv{kMotionPins[0]};
+#endif
     MotionStatus st;
 
+    // cfg speeds in Q16.16 so tick() never touches float (see MotionMath.h).
+    struct FixedConfig {
+        motion_math::q16 maxSps = 0;
+        motion_math::q16 minSps = 0;
+        motion_math::q16 accelPerMs = 1;   // Q16 steps/s gained per ms
+        uint32_t accel = 1;                // steps/s^2, >= 1
+        uint32_t minSpsInt = 1;            // steps/s, >= 1 (timeouts)
+        uint32_t jerk = 0;                 // steps/s^3, 0 = trapezoid profile
+        uint32_t zoneSps[kMotionZoneCount] = {};   // steps/s, 0 = slot unused
+    } fx;
+
+    motion_math::q16 speedQ = 0;           // st.currentSps mirrors the integer part
+    motion_math::q16 targetQ = 0;
+    uint32_t stepIntervalUs = 1000000;     // cached intervalUs(speedQ)
+    int32_t rampAccel = 0;                 // steps/s^2, S-curve rampSpeed() only
+
+    // Per-stroke accel/cruise/decel plan. While active it replaces rampSpeed();
+    // cleared together with the step stream (stopStepGen()).
+    MotionPlanner planner;
+
+    // Step generator (nullptr = polled). Queued pulses always belong to stepGenForward;
+    // every direction change goes through stopStepGen() first.
+    StepGenHal* stepGen = nullptr;
+    bool stepGenForward = true;
+    static constexpr uint32_t kStepLeadMs = 8;   // pulses kept queued ahead of tick()
+
     struct {
         uint32_t seq = 0;
         uint8_t head = 0;
@@ -271,8 +642,106 @@ private:
         bool lastHallR = false;
     } safety;
 
+    struct CatchUpPolicy {
+        // Polled mode: keep the ideal step schedule across loop() stalls instead of
+        // dropping the late time. Missed steps are re-emitted at up to capPercent of the
+        // speed they were planned at (>= 100, so catch-up never slows the stream).
+        bool enabled = true;
+        // Largest backlog (steps) worth catching up; anything older is dropped + counted.
+        uint8_t maxBurstSteps = 8;
+        uint16_t capPercent = 125;
+    } catchUp;
+
+    struct DriftPolicy {
+        bool enabled = true;
+        // Largest drift (fine steps) corrected in place; beyond this a full rehome runs.
+        // Covers switch hysteresis/noise plus a few lost full steps at 1/16.
+        uint32_t rehomeAboveSteps = 64;
+        bool rehomePending = false;        // set by an end hit, acted on at the Dwell exit
+        uint32_t lastPeriodicCycle = 0;    // cycles value the periodic check last fired at
+    } drift;
+    uint32_t homingStartMs = 0;
+    bool homingTimed = false;
+
+    struct ControlledStop {
+        bool forward = false;        // direction of the move being stopped
+        bool headingRight = false;   // resume direction for startFromRest()
+        bool restartAfter = false;   // requestStart() arrived while stopping
+        uint32_t timeoutMs = 0;      // ramp time from the entry speed + kStoppingMarginMs
+    } stopping;
+    static constexpr uint32_t kStoppingMarginMs = 1000;
+
+    struct WarmStart {
+        uint32_t travelSteps = 0;   // learned travel for finishHoming() to reuse (0 = calibrate)
+        bool verifying = false;     // next end hit checks the reused travel/position
+    } warm;
+
+    struct HomingPolicy {
+        // Seek fast to the first left-hall edge, back off, re-approach at minSps.
+        bool twoStage = true;
+        // Seek speed (% of minSps, capped at maxSps) when the position is not trusted and
+        // the seek can't decelerate ahead of the hall.
+        uint16_t blindSeekPercent = 200;
+        // Clear distance after the hall releases (fine steps). With a trusted position the
+        // seek also finishes its decel this far before the expected switch point.
+        uint32_t backoffSteps = 800;
+        uint32_t backoffLeft = 0;
+    } homing;
+
+    // Motion program queue. Only touched on the motion core (applyCommand()/tick()).
+    struct ProgramQueue {
+        static constexpr uint8_t kCapacity = 8;
+        MotionProgramStep steps[kCapacity];
+        uint8_t head = 0;
+        uint8_t count = 0;
+        uint16_t leg = 0;            // legs of the head Sweep already done
+        bool runAfterStop = false;   // Run arrived while a stroke was ramping down
+        bool forward = false;        // ProgramMove direction
+        long target = 0;             // ProgramMove target pos
+        uint32_t holdMs = 0;         // ProgramHold duration
+    } program;
+
+    struct PositionWindowPolicy {
+        // The hall should switch at pos 0 / travelSteps. A stroke that runs further than
+        // warnSteps past it without a hit (or hits that far early) counts posWindowWarns;
+        // beyond faultSteps it faults with PositionWindow right away instead of waiting
+        // for the travel timeout. Skipped for warm-start verification (drift check decides).
+        bool enabled = true;
+        uint32_t warnSteps = 400;
+        uint32_t faultSteps = 1600;   // 100 full steps at 1/16
+        bool warned = false;          // current stroke already counted
+    } posWindow;
+
+    struct AutoTuneState : AutoTuneSearch {
+        uint32_t seq = 0;
+        AutoTuneCallback cb = nullptr;
+    } tune;
+
+    struct MicrostepPolicy {
+        // Coarse steps at cruise (fewer pulses, less tick/PIO load), fine steps at low
+        // speed and near the ends. Needs MS1..MS3 wired (PinMap != 255).
+        bool enabled = (PIN_MS1 != 255 && PIN_MS2 != 255 && PIN_MS3 != 255);   // see setChannel()
+        uint8_t fineDiv = 16;
+        uint8_t coarseDiv = 4;
+        uint32_t coarseAboveSps = 2400;   // fine -> coarse at/above this speed
+        uint32_t fineBelowSps = 1800;     // coarse -> fine at/below (hysteresis)
+    } ustep;
+    // Stay fine within this many coarse pulses of either end.
+    static constexpr uint32_t kUstepEndWindowPulses = 32;
+    bool msWired = (PIN_MS1 != 255 && PIN_MS2 != 255 && PIN_MS3 != 255);
+    uint8_t ustepShift = 0;
+    // polled: fine steps the planner has walked past st.pos + the pending pulse (a coarse
+    // pulse was planned, then the switch to fine made it shorter); emitted before the
+    // planner is advanced again
+    uint32_t plannerLeadSteps = 0;
+    uint32_t pulseIntervalUs = 1000000;   // polled: interval of the next pulse (active resolution)
+
     uint32_t stateEnterMs = 0;
     uint32_t lastStepUs = 0;
+    uint32_t stepDueUs = 0;        // ideal time of the next polled step
+    bool stepSchedValid = false;   // false: restart schedule from lastStepUs
+    bool stepGenStreaming = false; // generator has been fed since the last stop
+    bool steppedSinceRest = false; // a pulse went out since the last Dwell/Stopped
     uint32_t lastRampMs = 0;
 
     uint32_t calibSteps = 0;
@@ -281,6 +750,20 @@ private:
 
     uint32_t bothActiveSinceMs = 0;
 
+    uint32_t hallGlitchUs = 200;
+#if MOTION_HALL_IRQ
+    // Filtered per-sensor state built from the ISR edge queue ([0] = left, [1] = right).
+    struct HallInput {
+        bool level = false;     // confirmed (filtered) level
+        bool pending = false;   // `cand` is waiting out the glitch window
+        HallEdge cand;
+        bool latched = false;   // confirmed active edge not yet taken by the FSM
+        long latchPos = 0;
+    } hallIn[2];
+    platform::util::SpscRing<HallEdge, 16> hallQ;   // ISR -> tick
+    volatile bool hallQOverflow = false;
+#endif
+
     MotionState nextAfterDwell = MotionState::MoveRight;
 
     struct SimHall {
@@ -293,24 +776,32 @@ private:
     // UI/Test mute window (ms). Used to suppress popups/alerts while scripted validation is running.
     uint32_t uiMuteUntilMs = 0;
 
-    struct Pending {
-        bool start = false;
-        bool stop = false;
-        bool home = false;
-        bool recalibrate = false;
-        bool forceMoveLeft = false;
-        bool forceMoveRight = false;
-        bool injectFault = false;
-        bool setMaxSps = false;
-        bool setAccel = false;
-        bool setDwell = false;
-        bool setRehome = false;
-        MotionError faultToInject = MotionError::None;
-        float maxSps = 0;
-        float accel = 0;
-        uint32_t dwellMs = 0;
-        uint32_t rehomeEvery = 0;
-    } pending;
+    // Command/event queues (replace the old Pending flags). Single producer each:
+    // commands are pushed by core0 only, events by the motion core only.
+    platform::util::SpscRing<MotionCommand, 32> cmdQ;
+    platform::util::SpscRing<MotionEvent, 16> evtQ;
+    volatile uint32_t cmdDropped = 0;   // core0: queue full (should never happen)
+
+#if MOTION_ON_CORE1
+    // Seqlock publication (motion core writes, readers copy without locks). Constructed with
+    // the controller and never re-initialised: core0 may read them while core1 runs begin().
+    // Full status is republished on state/err/alert/factory changes, else at most every kFullPublishUs.
+    static constexpr uint32_t kFullPublishUs = 1000;
+    platform::util::SeqLock<MotionStatus> stPub;
+    platform::util::SeqLock<MotionConfig> cfgPub;
+    platform::util::SeqLock<MotionHotStatus> hotPub;
+    uint32_t lastFullPublishUs = 0;
+    MotionState pubState = MotionState::HomingLeft;
+    MotionError pubErr = MotionError::None;
+    uint32_t pubAlertSeq = 0;
+    uint32_t pubFactorySeq = 0;
+    bool cfgChanged = true;
+
+    struct {
+        MotionStatus st;
+        MotionConfig cfg;
+    } view;   // core0 only
+#endif
 
     struct AutoHallTest {
         bool enabled = false;
@@ -327,4 +818,6 @@ private:
         uint32_t startMs = 0;
         uint8_t failStep = 1;
     } fauto;
+    volatile uint32_t fautoRequested = 0;   // core0: FactoryStart commands queued
+    volatile uint32_t fautoApplied = 0;     // motion core: FactoryStart commands applied
 };
\ No newline at end of file
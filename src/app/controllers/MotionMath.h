@@ -0,0 +1,88 @@
+#pragma once
+#include <stdint.h>
+
+// Integer motion math for the tick path.
+// RP2040 (Cortex-M0+) has no FPU: every float op is a soft-float call, while 32-bit
+// integer divides go to the SIO hardware divider. MotionConfig stays float (UI/EEPROM
+// format); MotionController converts it once with toQ16() when the config is applied.
+//
+// Units: speed/accel are Q16.16 steps/s (steps/s^2), intervals are whole microseconds.
+namespace motion_math {
+
+using q16 = uint32_t;
+static constexpr uint32_t kQ16Shift = 16;
+static constexpr q16 kQ16Max = 0xFFFF0000u;   // 65535 steps/s
+
+// Config-time only. Negative/NaN -> 0, saturates at kQ16Max.
+inline q16 toQ16(float v) {
+    if (!(v > 0.0f)) return 0;
+    if (v >= 65535.0f) return kQ16Max;
+    return (q16)(v * 65536.0f);
+}
+
+inline uint32_t toInt(q16 v) { return v >> kQ16Shift; }
+inline q16 fromInt(uint32_t v) { return (v >= 0xFFFFu) ? kQ16Max : (v << kQ16Shift); }
+
+// Step interval for a speed. Divides in Q8 so 1e6 << 8 still fits 32 bits;
+// anything slower than 1 step/s is clamped to 1 s (same as the old maxf(sps, 1)).
+inline uint32_t intervalUs(q16 sps) {
+    const uint32_t q8 = sps >> 8;
+    if (q8 <= 256) return 1000000u;
+    return 256000000u / q8;
+}
+
+// Q16 speed change per elapsed millisecond for an acceleration (never 0).
+inline q16 accelPerMs(q16 accel) {
+    const q16 d = accel / 1000u;
+    return d ? d : 1;
+}
+
+// Steps needed to brake from v to 0 at accel (whole steps/s^2, >= 1): v^2 / 2a.
+// v <= 65535 so v*v fits in uint32.
+inline uint32_t brakeSteps(q16 v, uint32_t accel) {
+    const uint32_t vi = toInt(v);
+    return (vi * vi) / (2u * accel);
+}
+
+// Time (ms) to cover `steps` at a constant `sps` (whole steps/s, >= 1), no 64-bit math.
+inline uint32_t travelMs(uint32_t steps, uint32_t sps) {
+    if (sps == 0) sps = 1;
+    return (steps / sps) * 1000u + ((steps % sps) * 1000u) / sps;
+}
+
+// floor(sqrt(x)), shift/add only (no divide).
+inline uint32_t isqrt(uint32_t x) {
+    uint32_t r = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > x) bit >>= 2;
+    while (bit) {
+        if (x >= r + bit) {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+// floor(sqrt(x)) for 64-bit operands (accel^2 above 65535 steps/s^2).
+inline uint32_t isqrt64(uint64_t x) {
+    if (x <= 0xFFFFFFFFull) return isqrt((uint32_t)x);
+    uint64_t r = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > x) bit >>= 2;
+    while (bit) {
+        if (x >= r + bit) {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+} // namespace motion_math
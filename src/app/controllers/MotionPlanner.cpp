@@ -0,0 +1,283 @@
+#include "MotionPlanner.h"
+#include "MotionMath.h"
+
+using motion_math::isqrt;
+
+bool MotionPlanner::plan(uint32_t steps, uint32_t vStart, uint32_t vCruise, uint32_t vEnd,
+                         uint32_t accel, uint32_t jerk) {
+    Leg one;
+    one.steps = steps;
+    one.vCruise = vCruise;
+    return planLegs(&one, 1, vStart, vEnd, accel, jerk);
+}
+
+bool MotionPlanner::planLegs(const Leg* legs, uint8_t count, uint32_t vStart, uint32_t vEnd,
+                             uint32_t accel, uint32_t jerk) {
+    clear();
+    if (accel == 0) accel = 1;
+
+    uint8_t n = 0;
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < count && n < kMaxLegs; i++) {
+        if (legs[i].steps == 0) continue;
+        legTab[n] = legs[i];
+        if (legTab[n].vCruise == 0) legTab[n].vCruise = 1;
+        total += legs[i].steps;
+        n++;
+    }
+    if (n == 0) return false;
+
+    // Join speeds: the slower neighbour, then what each leg can brake to (backward)
+    // and accelerate to (forward) over its own length. vStart is where we are.
+    uint32_t* v = joinSps;
+    v[0] = (vStart < legTab[0].vCruise) ? vStart : legTab[0].vCruise;
+    v[n] = (vEnd < legTab[n - 1].vCruise) ? vEnd : legTab[n - 1].vCruise;
+    for (uint8_t k = 1; k < n; k++) {
+        v[k] = (legTab[k - 1].vCruise < legTab[k].vCruise) ? legTab[k - 1].vCruise : legTab[k].vCruise;
+    }
+    for (uint8_t k = n - 1; k >= 1; k--) {
+        v[k] = reachable(v[k + 1], legTab[k].steps, v[k], accel, jerk);
+    }
+    for (uint8_t k = 1; k <= n; k++) {
+        v[k] = reachable(v[k - 1], legTab[k - 1].steps, v[k], accel, jerk);
+    }
+
+    legCount = n;
+    totalSteps = total;
+    seg.accel = accel;
+    seg.jerk = jerk;
+    startLeg(0);
+
+    planned = true;
+    lastSps = seg.vStart;
+    lastIntervalUs = firstIntervalUs();
+    lastIntervalFrac = 0;
+    return true;
+}
+
+void MotionPlanner::startLeg(uint8_t i) {
+    const uint32_t accel = seg.accel;
+    const uint32_t jerk = seg.jerk;
+    const uint32_t steps = legTab[i].steps;
+    const uint32_t vCruise = legTab[i].vCruise;
+
+    seg = Segments{};
+    rampUp = Ramp{};
+    rampDown = Ramp{};
+    tUpUs = 0;
+    tDownUs = 0;
+    tFrac = 0;
+    leg = i;
+    index = 0;
+
+    seg.steps = steps;
+    seg.vStart = (joinSps[i] < vCruise) ? joinSps[i] : vCruise;
+    seg.vEnd = (joinSps[i + 1] < vCruise) ? joinSps[i + 1] : vCruise;
+    seg.accel = accel;
+    seg.jerk = jerk;
+    if (jerk) planSCurve(steps, vCruise);
+    else { seg.vPeak = vCruise; planTrapezoid(steps); }
+}
+
+uint32_t MotionPlanner::reachable(uint32_t v0, uint32_t steps, uint32_t vCap,
+                                  uint32_t accel, uint32_t jerk) {
+    if (v0 >= vCap) return vCap;
+    if (!jerk) {
+        const uint64_t vs = (uint64_t)v0 * v0 + 2ull * accel * steps;
+        return (vs >= (uint64_t)vCap * vCap) ? vCap : isqrt((uint32_t)vs);
+    }
+    if (makeRamp(v0, vCap, accel, jerk).steps <= steps) return vCap;
+    uint32_t lo = v0;
+    uint32_t hi = vCap;
+    while (lo + 1 < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (makeRamp(v0, mid, accel, jerk).steps <= steps) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void MotionPlanner::clear() {
+    seg = Segments{};
+    rampUp = Ramp{};
+    rampDown = Ramp{};
+    tUpUs = 0;
+    tDownUs = 0;
+    tFrac = 0;
+    lastIntervalUs = 0;
+    lastIntervalFrac = 0;
+    legCount = 0;
+    leg = 0;
+    legBase = 0;
+    totalSteps = 0;
+    planned = false;
+    index = 0;
+    lastSps = 0;
+}
+
+bool MotionPlanner::planTrapezoid(uint32_t steps) {
+    // Work in v^2 (fits 32 bits for v <= 65535); once-per-stroke, so 64-bit is fine here.
+    const uint64_t twoA = 2ull * seg.accel;
+    const uint64_t v0s = (uint64_t)seg.vStart * seg.vStart;
+    const uint64_t ves = (uint64_t)seg.vEnd * seg.vEnd;
+    uint64_t vps = (uint64_t)seg.vPeak * seg.vPeak;
+
+    uint64_t na = (vps - v0s) / twoA;
+    uint64_t nd = (vps - ves) / twoA;
+
+    if (na + nd > steps) {
+        // Short stroke: no cruise. Peak where accel and decel ramps meet.
+        vps = (twoA * steps + v0s + ves) / 2;
+        const uint64_t floorS = (v0s > ves) ? v0s : ves;
+        if (vps < floorS) vps = floorS;
+        na = (vps - v0s) / twoA;
+        if (na > steps) na = steps;
+        nd = steps - na;
+    }
+
+    seg.accelSteps = (uint32_t)na;
+    seg.decelSteps = (uint32_t)nd;
+    seg.cruiseSteps = steps - (uint32_t)(na + nd);
+    seg.vPeak = isqrt((uint32_t)vps);
+    return true;
+}
+
+MotionPlanner::Ramp MotionPlanner::makeRamp(uint32_t vLo, uint32_t vHi, uint32_t accel, uint32_t jerk) {
+    Ramp r;
+    if (vHi <= vLo) return r;
+
+    r.dv = vHi - vLo;
+    if ((uint64_t)r.dv * jerk >= (uint64_t)accel * accel) {
+        // Reaches full accel: jerk-up, constant accel, jerk-down.
+        r.aPk = accel;
+        r.t1Us = (uint32_t)(((uint64_t)accel * 1000000u) / jerk);
+        r.tUs = (uint32_t)(((uint64_t)r.dv * 1000000u) / accel) + r.t1Us;
+    } else {
+        // Small dv: accel peaks at sqrt(dv * jerk), no constant-accel phase.
+        r.aPk = isqrt(r.dv * jerk);
+        if (r.aPk == 0) r.aPk = 1;
+        r.t1Us = (uint32_t)(((uint64_t)r.aPk * 1000000u) / jerk);
+        r.tUs = 2u * r.t1Us;
+    }
+    // Symmetric ramp: distance = average speed * time (rounded up).
+    r.steps = (uint32_t)(((uint64_t)(vLo + vHi) * r.tUs + 1999999u) / 2000000u);
+    return r;
+}
+
+uint32_t MotionPlanner::rise(const Ramp& r, uint32_t tUs) {
+    if (tUs >= r.tUs) return r.dv;
+
+    uint64_t dv;
+    if (tUs < r.t1Us) {
+        dv = ((uint64_t)r.aPk * tUs / 1000000u) * tUs / (2u * (uint64_t)r.t1Us);
+    } else if (tUs <= r.tUs - r.t1Us) {
+        dv = (uint64_t)r.aPk * r.t1Us / 2000000u + (uint64_t)r.aPk * (tUs - r.t1Us) / 1000000u;
+    } else {
+        const uint32_t u = r.tUs - tUs;
+        const uint64_t tail = ((uint64_t)r.aPk * u / 1000000u) * u / (2u * (uint64_t)r.t1Us);
+        dv = (tail < r.dv) ? r.dv - tail : 0;
+    }
+    return (dv > r.dv) ? r.dv : (uint32_t)dv;
+}
+
+bool MotionPlanner::planSCurve(uint32_t steps, uint32_t vCruise) {
+    const uint32_t vLo = (seg.vStart > seg.vEnd) ? seg.vStart : seg.vEnd;
+
+    auto fits = [&](uint32_t vp) {
+        const Ramp up = makeRamp(seg.vStart, vp, seg.accel, seg.jerk);
+        const Ramp dn = makeRamp(seg.vEnd, vp, seg.accel, seg.jerk);
+        return (uint64_t)up.steps + dn.steps <= steps;
+    };
+
+    uint32_t vp = vCruise;
+    if (!fits(vp)) {
+        // Largest peak whose two ramps still fit the stroke.
+        uint32_t lo = vLo;
+        uint32_t hi = vCruise;
+        while (lo + 1 < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            if (fits(mid)) lo = mid;
+            else hi = mid;
+        }
+        vp = lo;
+    }
+
+    rampUp = makeRamp(seg.vStart, vp, seg.accel, seg.jerk);
+    rampDown = makeRamp(seg.vEnd, vp, seg.accel, seg.jerk);
+
+    uint32_t na = rampUp.steps;
+    uint32_t nd = rampDown.steps;
+    if (na > steps) na = steps;
+    if (nd > steps - na) nd = steps - na;
+
+    seg.vPeak = vp;
+    seg.accelSteps = na;
+    seg.decelSteps = nd;
+    seg.cruiseSteps = steps - na - nd;
+    return true;
+}
+
+uint32_t MotionPlanner::speedAt(uint32_t i) const {
+    if (i >= seg.steps) return seg.vEnd;
+
+    const uint32_t peakS = seg.vPeak * seg.vPeak;
+    uint32_t vs = peakS;
+
+    if (i < seg.accelSteps) {
+        vs = seg.vStart * seg.vStart + 2u * seg.accel * i;
+    } else {
+        const uint32_t left = seg.steps - i;   // >= 1; last step is taken at vEnd
+        if (left <= seg.decelSteps) vs = seg.vEnd * seg.vEnd + 2u * seg.accel * (left - 1);
+    }
+    if (vs > peakS) vs = peakS;
+    return isqrt(vs);
+}
+
+uint32_t MotionPlanner::speedSCurve(uint32_t i) {
+    if (i >= seg.steps) return seg.vEnd;
+
+    if (i < seg.accelSteps) {
+        if (i > 0) advanceClock(tUpUs);
+        return seg.vStart + rise(rampUp, tUpUs);
+    }
+    const uint32_t left = seg.steps - i;
+    if (left <= seg.decelSteps) {
+        if (left < seg.decelSteps) advanceClock(tDownUs);
+        else tFrac = 0;
+        uint32_t v = seg.vPeak - rise(rampDown, tDownUs);
+        if (v < seg.vEnd) v = seg.vEnd;
+        // The clock only approximates the ramp; never approach the end faster than the
+        // trapezoid would (v^2 = vEnd^2 + 2*a*(left-1)), so the last step is taken at vEnd.
+        const uint64_t capS = (uint64_t)seg.vEnd * seg.vEnd + 2ull * seg.accel * (left - 1);
+        if (capS < (uint64_t)v * v) v = isqrt((uint32_t)capS);
+        return v;
+    }
+    return seg.vPeak;
+}
+
+void MotionPlanner::advanceClock(uint32_t& tUs) {
+    // truncated intervals would lag the clock by ~0.5 us per step: over a long decel the
+    // ramp then ends well above vEnd
+    tFrac += lastIntervalFrac;
+    tUs += lastIntervalUs + (tFrac >> 8);
+    tFrac &= 0xFFu;
+}
+
+uint32_t MotionPlanner::nextIntervalUs() {
+    if (index >= seg.steps && leg + 1 < legCount) {
+        // next leg starts at the join speed the previous one ended on
+        legBase += seg.steps;
+        startLeg(leg + 1);
+    }
+    uint32_t v = seg.jerk ? speedSCurve(index) : speedAt(index);
+    if (index < seg.steps) index++;
+    if (v == 0) v = 1;
+    lastSps = v;
+    lastIntervalUs = 1000000u / v;
+    if (seg.jerk) lastIntervalFrac = ((1000000u % v) << 8) / v;
+    return lastIntervalUs;
+}
+
+uint32_t MotionPlanner::firstIntervalUs() const {
+    return 1000000u / (seg.vStart ? seg.vStart : 1);
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <stdint.h>
+
+// Stroke planner: accel / cruise / decel over a known step count.
+//
+// plan() runs once when a stroke starts and reduces the profile to three segment
+// lengths plus the peak speed. nextIntervalUs() then walks the stroke one step at a
+// time, so the last planned step lands on vEnd. Steps past the end (hall not reached
+// yet) crawl at vEnd.
+//
+// - jerk == 0: trapezoid, v^2 = v0^2 + 2*a*n per step (exact, no ms quantization).
+// - jerk  > 0: S-curve. Each ramp is jerk-up / const-accel / jerk-down, evaluated in the
+//   time domain (ramp clock advanced by each emitted interval). Ramp lengths come from
+//   the closed form dist = (v0 + v1) / 2 * T; short strokes binary-search the peak.
+//
+// planLegs() chains several cruise speeds over one stroke (speed zones). The speed at
+// each join is the lower of the two cruise speeds, then limited by a backward and a
+// forward pass so every leg can reach it within its own length (v^2 = v0^2 + 2*a*n,
+// or the S-curve ramp length). Legs are planned one at a time as the walk reaches
+// them, so a plain plan() costs the same as before.
+//
+// Pure integer, no Arduino dependency. The S-curve path uses 64-bit multiplies/divides
+// (the RP2040 runtime routes those through the SIO divider).
+class MotionPlanner {
+public:
+    struct Segments {
+        uint32_t steps = 0;        // planned steps (of the current leg)
+        uint32_t accelSteps = 0;
+        uint32_t cruiseSteps = 0;
+        uint32_t decelSteps = 0;
+        uint32_t vStart = 0;       // steps/s
+        uint32_t vPeak = 0;        // may be below vCruise for short strokes
+        uint32_t vEnd = 0;
+        uint32_t accel = 1;        // steps/s^2
+        uint32_t jerk = 0;         // steps/s^3, 0 = trapezoid
+    };
+
+    // One cruise speed over `steps` consecutive steps of a multi-leg plan.
+    struct Leg {
+        uint32_t steps = 0;
+        uint32_t vCruise = 0;      // steps/s
+    };
+    static constexpr uint8_t kMaxLegs = 9;
+
+    // Speeds in whole steps/s, accel in steps/s^2, jerk in steps/s^3 (0 = trapezoid).
+    // Returns false (and stays idle) for steps == 0.
+    bool plan(uint32_t steps, uint32_t vStart, uint32_t vCruise, uint32_t vEnd,
+              uint32_t accel, uint32_t jerk = 0);
+    // Legs in travel order (zero-length legs are skipped, at most kMaxLegs).
+    // Returns false (and stays idle) if no leg has steps.
+    bool planLegs(const Leg* legs, uint8_t count, uint32_t vStart, uint32_t vEnd,
+                  uint32_t accel, uint32_t jerk = 0);
+    void clear();
+
+    bool active() const { return planned; }
+    bool done() const { return planned && leg + 1 >= legCount && index >= seg.steps; }
+
+    // Interval (us) after the next step; advances the plan by one step.
+    uint32_t nextIntervalUs();
+    // Interval (us) before the first step (speed vStart).
+    uint32_t firstIntervalUs() const;
+
+    uint32_t currentSps() const { return lastSps; }
+    uint32_t stepIndex() const { return legBase + index; }
+    uint32_t remaining() const { return (stepIndex() < totalSteps) ? totalSteps - stepIndex() : 0; }
+    // Segments of the leg being walked (the whole stroke for plan()).
+    const Segments& segments() const { return seg; }
+
+private:
+    // One jerk-limited ramp between two speeds (S-curve only).
+    struct Ramp {
+        uint32_t dv = 0;       // steps/s
+        uint32_t aPk = 0;      // reached accel, steps/s^2 (< accel if dv is small)
+        uint32_t t1Us = 0;     // jerk phase length
+        uint32_t tUs = 0;      // total ramp time
+        uint32_t steps = 0;    // distance covered
+    };
+    static Ramp makeRamp(uint32_t vLo, uint32_t vHi, uint32_t accel, uint32_t jerk);
+    static uint32_t rise(const Ramp& r, uint32_t tUs);
+    // Highest speed (<= vCap) reachable from v0 within `steps`.
+    static uint32_t reachable(uint32_t v0, uint32_t steps, uint32_t vCap,
+                              uint32_t accel, uint32_t jerk);
+
+    void startLeg(uint8_t i);
+
+    bool planTrapezoid(uint32_t steps);
+    bool planSCurve(uint32_t steps, uint32_t vCruise);
+    uint32_t speedAt(uint32_t i) const;        // trapezoid
+    uint32_t speedSCurve(uint32_t i);          // S-curve (advances ramp clocks)
+    void advanceClock(uint32_t& tUs);          // + last interval, sub-us part carried
+
+    Segments seg;
+    Ramp rampUp;
+    Ramp rampDown;
+    uint32_t tUpUs = 0;
+    uint32_t tDownUs = 0;
+    uint32_t tFrac = 0;                    // ramp clock below 1 us (1/256 us)
+    uint32_t lastIntervalUs = 0;
+    uint32_t lastIntervalFrac = 0;         // 1/256 us dropped by the integer interval
+
+    Leg legTab[kMaxLegs];
+    uint32_t joinSps[kMaxLegs + 1] = {};   // speed at the start of each leg (+ end)
+    uint8_t legCount = 0;
+    uint8_t leg = 0;
+    uint32_t legBase = 0;                  // steps in the legs already walked
+    uint32_t totalSteps = 0;
+
+    bool planned = false;
+    uint32_t index = 0;                    // within the current leg
+    uint32_t lastSps = 0;
+};
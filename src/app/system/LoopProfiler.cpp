@@ -0,0 +1,70 @@
+#include "LoopProfiler.h"
+
+#if LOOP_PROFILER
+#include <hardware/clocks.h>
+#include <hardware/structs/sio.h>
+#include <hardware/structs/systick.h>
+
+LoopProfiler::PhaseStats LoopProfiler::s_stats[LoopProfiler::kPhases];
+uint32_t LoopProfiler::s_cyclesPerUs = 125;
+uint32_t LoopProfiler::s_sysTickMaxSpanUs = 0;   // micros() only until beginCore()
+bool LoopProfiler::s_sysTick[2] = {false, false};
+
+static constexpr uint32_t kSysTickMask = 0x00FFFFFFu;
+static constexpr uint32_t kCsrEnable = 1u << 0;
+static constexpr uint32_t kCsrClkSource = 1u << 2;      // processor clock
+
+void LoopProfiler::beginCore() {
+    const uint32_t hz = clock_get_hz(clk_sys);
+    if (hz >= 1000000) s_cyclesPerUs = hz / 1000000;
+    // 24 bit wrap time at this clock (~134 ms @125 MHz, ~63 ms @266 MHz) minus 1/8 for the
+    // skew between the micros() and SysTick reads of one span
+    const uint32_t wrapUs = kSysTickMask / s_cyclesPerUs;
+    s_sysTickMaxSpanUs = wrapUs - wrapUs / 8;
+
+    // leave SysTick alone if someone else (an RTOS tick) already runs it
+    const uint8_t core = (uint8_t)(sio_hw->cpuid & 1);
+    if (systick_hw->csr & kCsrEnable) return;
+    systick_hw->rvr = kSysTickMask;
+    systick_hw->cvr = 0;
+    systick_hw->csr = kCsrClkSource | kCsrEnable;   // no interrupt
+    s_sysTick[core] = true;
+}
+
+uint32_t LoopProfiler::tickNow() {
+    return s_sysTick[sio_hw->cpuid & 1] ? systick_hw->cvr : 0;
+}
+
+uint32_t LoopProfiler::spanCycles(uint32_t t0Tick, uint32_t t1Tick, uint32_t dUs) {
+    if (s_sysTick[sio_hw->cpuid & 1] && dUs < s_sysTickMaxSpanUs) {
+        return (t0Tick - t1Tick) & kSysTickMask;   // counts down
+    }
+    if (dUs > UINT32_MAX / s_cyclesPerUs) return UINT32_MAX;
+    return dUs * s_cyclesPerUs;
+}
+
+void LoopProfiler::record(ProfPhase phase, uint32_t cycles) {
+    PhaseStats& s = s_stats[(uint8_t)phase];
+    if (s.count == 0 || cycles < s.minCyc) s.minCyc = cycles;
+    if (cycles > s.maxCyc) s.maxCyc = cycles;
+    s.sumCyc += cycles;
+    s.count++;
+
+    uint8_t bin = 0;
+    for (uint32_t v = cycles >> (kBinShift + 1); v != 0 && bin < kBins - 1; v >>= 1) bin++;
+    if (s.hist[bin] != UINT16_MAX) s.hist[bin]++;
+}
+
+void LoopProfiler::reset() {
+    for (uint8_t i = 0; i < kPhases; i++) s_stats[i] = PhaseStats{};
+}
+
+const char* LoopProfiler::name(ProfPhase phase) {
+    static const char* const kNames[kPhases] = {
+        "enc", "motion", "sensor", "vm", "render", "send", "save", "log"
+    };
+    const uint8_t i = (uint8_t)phase;
+    return (i < kPhases) ? kNames[i] : "?";
+}
+
+#endif // LOOP_PROFILER
@@ -0,0 +1,102 @@
+#pragma once
+#include <Arduino.h>
+#include "../../config/Features.h"
+
+// Per-phase loop profiler (LOOP_PROFILER=1): cycle min/avg/max and a log2 histogram for
+// each phase, in fixed RAM. Probes are PROF_SCOPE()/PROF_BEGIN()/PROF_END(); with the
+// feature off they expand to nothing and this class is never referenced.
+//
+// Cycles come from SysTick (clk_sys, 24 bit, per core) once beginCore() has claimed it on
+// that core; spans near the 24-bit wrap (7/8 of it, ~117 ms at 125 MHz, derived from clk_sys)
+// or a core without SysTick use micros() scaled to cycles, so a wrap never shortens a long phase. Each phase is written by one core
+// only; a reader on the other core may see one sample half-applied (diagnostics only).
+enum class ProfPhase : uint8_t {
+    EncPoll = 0,
+    MotionTick,
+    UiSensor,       // AHT read
+    UiViewModel,    // status copy + view-model build
+    UiRender,       // u8g2 drawing into the frame buffer
+    UiSendBuffer,   // frame buffer -> OLED (I2C)
+    StoreSave,      // EEPROM commit
+    SerialLog,      // 1 Hz status line
+    Count
+};
+
+class LoopProfiler {
+public:
+    static constexpr uint8_t kPhases = (uint8_t)ProfPhase::Count;
+    // bin 0: < 2^(kBinShift+1) cycles, bin i: [2^(i+kBinShift), 2^(i+kBinShift+1)),
+    // last bin: everything above (at 125 MHz: bin 0 < ~1 us, bin 19 >= ~268 ms)
+    static constexpr uint8_t kBins = 20;
+    static constexpr uint8_t kBinShift = 6;
+
+    struct PhaseStats {
+        uint32_t count = 0;
+        uint32_t minCyc = 0;
+        uint32_t maxCyc = 0;
+        uint64_t sumCyc = 0;
+        uint16_t hist[kBins] = {};   // saturating
+    };
+
+    // Claim SysTick on the calling core (once per core, from setup()/setup1()).
+    static void beginCore();
+
+    static void record(ProfPhase phase, uint32_t cycles);
+    static void reset();
+
+    static const PhaseStats& stats(ProfPhase phase) { return s_stats[(uint8_t)phase]; }
+    static const char* name(ProfPhase phase);
+    static uint32_t cyclesPerUs() { return s_cyclesPerUs; }
+    static uint32_t toUs(uint32_t cycles) { return cycles / s_cyclesPerUs; }
+    static uint32_t avgCyc(const PhaseStats& s) {
+        return s.count ? (uint32_t)(s.sumCyc / s.count) : 0;
+    }
+    // Lower bound of bin i in us (0 for the bins below 1 us).
+    static uint32_t binFloorUs(uint8_t bin) {
+        return bin == 0 ? 0 : toUs(1ul << (bin + kBinShift));
+    }
+
+    class Scope {
+    public:
+        explicit Scope(ProfPhase p) : phase(p), t0Us(micros()), t0Tick(tickNow()) {}
+        ~Scope() { stop(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        void stop() {
+            if (!running) return;
+            running = false;
+            const uint32_t tick = tickNow();
+            const uint32_t dUs = micros() - t0Us;
+            record(phase, spanCycles(t0Tick, tick, dUs));
+        }
+
+    private:
+        ProfPhase phase;
+        uint32_t t0Us;
+        uint32_t t0Tick;
+        bool running = true;
+    };
+
+private:
+    // SysTick current value on this core (counts down), or 0 when not claimed.
+    static uint32_t tickNow();
+    static uint32_t spanCycles(uint32_t t0Tick, uint32_t t1Tick, uint32_t dUs);
+
+    static PhaseStats s_stats[kPhases];
+    static uint32_t s_cyclesPerUs;
+    static uint32_t s_sysTickMaxSpanUs;   // below this a span is read from SysTick
+    static bool s_sysTick[2];
+};
+
+#if LOOP_PROFILER
+#define PROF_CAT2(a, b) a##b
+#define PROF_CAT(a, b) PROF_CAT2(a, b)
+#define PROF_SCOPE(phase)       LoopProfiler::Scope PROF_CAT(profScope_, __LINE__)(phase)
+#define PROF_BEGIN(var, phase)  LoopProfiler::Scope var(phase)
+#define PROF_END(var)           var.stop()
+#else
+#define PROF_SCOPE(phase)       do {} while (0)
+#define PROF_BEGIN(var, phase)  do {} while (0)
+#define PROF_END(var)           do {} while (0)
+#endif
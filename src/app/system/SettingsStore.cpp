@@ -1,4 +1,5 @@
 #include "SettingsStore.h"
+#include "LoopProfiler.h"
 
 uint32_t SettingsStore::calcCRC(const PersistedData& d) {
     const uint8_t* p = reinterpret_cast<const uint8_t*>(&d);
@@ -10,12 +11,141 @@ uint32_t SettingsStore::calcCRC(const PersistedData& d) {
     return crc;
 }
 
+static_assert(sizeof(PersistedData) <= SettingsStore::CHANNEL_BASE, "PersistedData overlaps channel slots");
+static_assert(sizeof(PersistedChannel) <= SettingsStore::CHANNEL_SLOT, "PersistedChannel exceeds its slot");
+static_assert(SettingsStore::CHANNEL_BASE + 2 * SettingsStore::CHANNEL_SLOT <= SettingsStore::EEPROM_SIZE,
+              "EEPROM too small for the extra channels");
+
+// MotionConfig as stored by v1..v5 (before profile/jerk). Frozen: do not edit.
+struct MotionConfigV5 {
+    float maxSps = 3000.0f;
+    float minSps = 1200.0f;
+    float accel  = 600.0f;
+    uint32_t dwellMs = 300;
+    uint32_t homingTimeoutMs = 15000;
+    uint32_t travelTimeoutMs = 25000;
+    uint32_t rehomeEveryCycles = 200;
+};
+
+static void migrateCfgV5(MotionConfig& dst, const MotionConfigV5& src) {
+    dst = MotionConfig{};   // new fields keep their defaults
+    dst.maxSps = src.maxSps;
+    dst.minSps = src.minSps;
+    dst.accel = src.accel;
+    dst.dwellMs = src.dwellMs;
+    dst.homingTimeoutMs = src.homingTimeoutMs;
+    dst.travelTimeoutMs = src.travelTimeoutMs;
+    dst.rehomeEveryCycles = src.rehomeEveryCycles;
+}
+
+// MotionConfig as stored by v6..v7 (profile/jerk added). Frozen: do not edit.
+struct MotionConfigV6 {
+    float maxSps = 3000.0f;
+    float minSps = 1200.0f;
+    float accel  = 600.0f;
+    uint32_t dwellMs = 300;
+    uint32_t homingTimeoutMs = 15000;
+    uint32_t travelTimeoutMs = 25000;
+    uint32_t rehomeEveryCycles = 200;
+    MotionProfile profile = MotionProfile::Trapezoid;
+    float jerk = 3000.0f;
+};
+
+static void migrateCfgV6(MotionConfig& dst, const MotionConfigV6& src) {
+    dst = MotionConfig{};   // new fields keep their defaults
+    dst.maxSps = src.maxSps;
+    dst.minSps = src.minSps;
+    dst.accel = src.accel;
+    dst.dwellMs = src.dwellMs;
+    dst.homingTimeoutMs = src.homingTimeoutMs;
+    dst.travelTimeoutMs = src.travelTimeoutMs;
+    dst.rehomeEveryCycles = src.rehomeEveryCycles;
+    dst.profile = src.profile;
+    dst.jerk = src.jerk;
+}
+
+// MotionConfig as stored by v8 (reversal mode/settle added). Frozen: do not edit.
+struct MotionConfigV8 {
+    float maxSps = 3000.0f;
+    float minSps = 1200.0f;
+    float accel  = 600.0f;
+    uint32_t dwellMs = 300;
+    uint32_t homingTimeoutMs = 15000;
+    uint32_t travelTimeoutMs = 25000;
+    uint32_t rehomeEveryCycles = 200;
+    MotionProfile profile = MotionProfile::Trapezoid;
+    float jerk = 3000.0f;
+    ReversalMode reversal = ReversalMode::Dwell;
+    uint32_t reverseSettleMs = 0;
+};
+
+static void migrateCfgV8(MotionConfig& dst, const MotionConfigV8& src) {
+    dst = MotionConfig{};   // new fields keep their defaults
+    dst.maxSps = src.maxSps;
+    dst.minSps = src.minSps;
+    dst.accel = src.accel;
+    dst.dwellMs = src.dwellMs;
+    dst.homingTimeoutMs = src.homingTimeoutMs;
+    dst.travelTimeoutMs = src.travelTimeoutMs;
+    dst.rehomeEveryCycles = src.rehomeEveryCycles;
+    dst.profile = src.profile;
+    dst.jerk = src.jerk;
+    dst.reversal = src.reversal;
+    dst.reverseSettleMs = src.reverseSettleMs;
+}
+
+// CRC of an older layout (same scheme as calcCRC, over that struct's size).
+template <typename V>
+static bool crcMatches(const V& v) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+    uint32_t crc = 0;
+    for (size_t i = 0; i < sizeof(V) - sizeof(uint32_t); i++) {
+        crc = (crc * 33u) ^ p[i];
+    }
+    return crc == v.crc;
+}
+
+// Fields shared unchanged by v5+ layouts: fault counters, LED policy, alert log, factory result/log.
+template <typename V>
+static void copyCommonV5(PersistedData& out, const V& v) {
+    out.faultTotal = v.faultTotal;
+    out.lastFaultCode = v.lastFaultCode;
+    out.lastFaultUptimeMs = v.lastFaultUptimeMs;
+    out.resetCount = v.resetCount;
+    out.ledMode = v.ledMode;
+    out.ledManualOn = v.ledManualOn;
+    out.ledOnStartMin = v.ledOnStartMin;
+    out.ledOnEndMin = v.ledOnEndMin;
+    out.alertSeq = v.alertSeq;
+    out.alertHead = v.alertHead;
+    out.alertCount = v.alertCount;
+    for (uint8_t i = 0; i < 5; i++) { out.alertCodes[i] = v.alertCodes[i]; out.alertUptimeSec[i] = v.alertUptimeSec[i]; }
+    out.factorySeq = v.factorySeq;
+    out.factoryLastPass = v.factoryLastPass;
+    out.factoryFailCode = v.factoryFailCode;
+    out.factoryFailStep = v.factoryFailStep;
+    out.factoryLastDurationMs = v.factoryLastDurationMs;
+    out.factoryLastUptimeSec = v.factoryLastUptimeSec;
+    out.factoryPassCount = v.factoryPassCount;
+    out.factoryFailCount = v.factoryFailCount;
+    out.factoryLogHead = v.factoryLogHead;
+    out.factoryLogCount = v.factoryLogCount;
+    for (uint8_t i = 0; i < 8; i++) {
+        out.factoryLogPass[i] = v.factoryLogPass[i];
+        out.factoryLogFailCode[i] = v.factoryLogFailCode[i];
+        out.factoryLogFailStep[i] = v.factoryLogFailStep[i];
+        out.factoryLogDurationSec[i] = v.factoryLogDurationSec[i];
+        out.factoryLogUptimeSec[i] = v.factoryLogUptimeSec[i];
+        out.factoryLogCycles[i] = v.factoryLogCycles[i];
+    }
+}
+
 bool SettingsStore::load(PersistedData& out) {
     // Backward-compatible load for v1 -> v2 -> v3 migration.
     struct PersistedDataV1 {
         uint32_t magic   = 0x53464231;
         uint16_t version = 1;
-        MotionConfig cfg;
+        MotionConfigV5 cfg;
         uint32_t faultTotal = 0;
         uint8_t  lastFaultCode = 0;
         uint32_t lastFaultUptimeMs = 0;
@@ -26,7 +156,7 @@ bool SettingsStore::load(PersistedData& out) {
     struct PersistedDataV2 {
         uint32_t magic   = 0x53464231;
         uint16_t version = 2;
-        MotionConfig cfg;
+        MotionConfigV5 cfg;
         uint32_t faultTotal = 0;
         uint8_t  lastFaultCode = 0;
         uint32_t lastFaultUptimeMs = 0;
@@ -58,8 +188,8 @@ bool SettingsStore::load(PersistedData& out) {
 
         out = PersistedData{};
         out.magic = v1.magic;
-        out.version = 5;
-        out.cfg = v1.cfg;
+        out.version = 9;
+        migrateCfgV5(out.cfg, v1.cfg);
         out.faultTotal = v1.faultTotal;
         out.lastFaultCode = v1.lastFaultCode;
         out.lastFaultUptimeMs = v1.lastFaultUptimeMs;
@@ -80,8 +210,8 @@ bool SettingsStore::load(PersistedData& out) {
 
         out = PersistedData{};
         out.magic = v2.magic;
-        out.version = 5;
-        out.cfg = v2.cfg;
+        out.version = 9;
+        migrateCfgV5(out.cfg, v2.cfg);
         out.faultTotal = v2.faultTotal;
         out.lastFaultCode = v2.lastFaultCode;
         out.lastFaultUptimeMs = v2.lastFaultUptimeMs;
@@ -99,7 +229,7 @@ bool SettingsStore::load(PersistedData& out) {
         struct PersistedDataV3 {
             uint32_t magic   = 0x53464231;
             uint16_t version = 3;
-            MotionConfig cfg;
+            MotionConfigV5 cfg;
             uint32_t faultTotal = 0;
             uint8_t  lastFaultCode = 0;
             uint32_t lastFaultUptimeMs = 0;
@@ -127,8 +257,8 @@ bool SettingsStore::load(PersistedData& out) {
 
         out = PersistedData{};
         out.magic = v3.magic;
-        out.version = 5;
-        out.cfg = v3.cfg;
+        out.version = 9;
+        migrateCfgV5(out.cfg, v3.cfg);
         out.faultTotal = v3.faultTotal;
         out.lastFaultCode = v3.lastFaultCode;
         out.lastFaultUptimeMs = v3.lastFaultUptimeMs;
@@ -153,7 +283,7 @@ bool SettingsStore::load(PersistedData& out) {
         struct PersistedDataV4 {
             uint32_t magic   = 0x53464231;
             uint16_t version = 4;
-            MotionConfig cfg;
+            MotionConfigV5 cfg;
             uint32_t faultTotal = 0;
             uint8_t  lastFaultCode = 0;
             uint32_t lastFaultUptimeMs = 0;
@@ -189,8 +319,8 @@ bool SettingsStore::load(PersistedData& out) {
         out = PersistedData{};
         // copy whole v4 blob into v5-compatible struct field-by-field
         out.magic = v4.magic;
-        out.version = 5;
-        out.cfg = v4.cfg;
+        out.version = 9;
+        migrateCfgV5(out.cfg, v4.cfg);
         out.faultTotal = v4.faultTotal;
         out.lastFaultCode = v4.lastFaultCode;
         out.lastFaultUptimeMs = v4.lastFaultUptimeMs;
@@ -215,14 +345,247 @@ bool SettingsStore::load(PersistedData& out) {
         return true;
     }
 
-    if (version != 5) return false;
+    if (version == 5) {
+        // v5 -> v6 migration (MotionConfig gains profile/jerk; rest of the layout unchanged)
+        struct PersistedDataV5 {
+            uint32_t magic   = 0x53464231;
+            uint16_t version = 5;
+            MotionConfigV5 cfg;
+            uint32_t faultTotal = 0;
+            uint8_t  lastFaultCode = 0;
+            uint32_t lastFaultUptimeMs = 0;
+            uint32_t resetCount = 0;
+            uint8_t  ledMode = 0;
+            uint8_t  ledManualOn = 1;
+            uint16_t ledOnStartMin = 8*60;
+            uint16_t ledOnEndMin   = 20*60;
+            uint32_t alertSeq = 0;
+            uint8_t  alertHead = 0;
+            uint8_t  alertCount = 0;
+            uint8_t  alertCodes[5] = {0};
+            uint32_t alertUptimeSec[5] = {0};
+            uint32_t factorySeq = 0;
+            uint8_t  factoryLastPass = 0;
+            uint8_t  factoryFailCode = 0;
+            uint8_t  factoryFailStep = 0;
+            uint32_t factoryLastDurationMs = 0;
+            uint32_t factoryLastUptimeSec = 0;
+            uint32_t factoryPassCount = 0;
+            uint32_t factoryFailCount = 0;
+            uint8_t  factoryLogHead = 0;
+            uint8_t  factoryLogCount = 0;
+            uint8_t  factoryLogPass[8] = {0};
+            uint8_t  factoryLogFailCode[8] = {0};
+            uint8_t  factoryLogFailStep[8] = {0};
+            uint16_t factoryLogDurationSec[8] = {0};
+            uint32_t factoryLogUptimeSec[8] = {0};
+            uint32_t factoryLogCycles[8] = {0};
+            uint32_t crc = 0;
+        };
+        PersistedDataV5 v5;
+        EEPROM.get(0, v5);
+        if (!crcMatches(v5)) return false;
+        out = PersistedData{};
+        out.magic = v5.magic;
+        out.version = 9;
+        migrateCfgV5(out.cfg, v5.cfg);
+        copyCommonV5(out, v5);
+        return true;
+    }
+
+    if (version == 6) {
+        // v6 -> v7 migration (adds learned travel / park position; rest unchanged)
+        struct PersistedDataV6 {
+            uint32_t magic   = 0x53464231;
+            uint16_t version = 6;
+            MotionConfigV6 cfg;
+            uint32_t faultTotal = 0;
+            uint8_t  lastFaultCode = 0;
+            uint32_t lastFaultUptimeMs = 0;
+            uint32_t resetCount = 0;
+            uint8_t  ledMode = 0;
+            uint8_t  ledManualOn = 1;
+            uint16_t ledOnStartMin = 8*60;
+            uint16_t ledOnEndMin   = 20*60;
+            uint32_t alertSeq = 0;
+            uint8_t  alertHead = 0;
+            uint8_t  alertCount = 0;
+            uint8_t  alertCodes[5] = {0};
+            uint32_t alertUptimeSec[5] = {0};
+            uint32_t factorySeq = 0;
+            uint8_t  factoryLastPass = 0;
+            uint8_t  factoryFailCode = 0;
+            uint8_t  factoryFailStep = 0;
+            uint32_t factoryLastDurationMs = 0;
+            uint32_t factoryLastUptimeSec = 0;
+            uint32_t factoryPassCount = 0;
+            uint32_t factoryFailCount = 0;
+            uint8_t  factoryLogHead = 0;
+            uint8_t  factoryLogCount = 0;
+            uint8_t  factoryLogPass[8] = {0};
+            uint8_t  factoryLogFailCode[8] = {0};
+            uint8_t  factoryLogFailStep[8] = {0};
+            uint16_t factoryLogDurationSec[8] = {0};
+            uint32_t factoryLogUptimeSec[8] = {0};
+            uint32_t factoryLogCycles[8] = {0};
+            uint32_t crc = 0;
+        };
+        PersistedDataV6 v6;
+        EEPROM.get(0, v6);
+        if (!crcMatches(v6)) return false;
+        out = PersistedData{};
+        out.magic = v6.magic;
+        out.version = 9;
+        migrateCfgV6(out.cfg, v6.cfg);
+        copyCommonV5(out, v6);
+        // no learned travel yet: first start calibrates
+        return true;
+    }
+
+    if (version == 7) {
+        // v7 -> v8 migration (MotionConfig gains reversal mode/settle; rest unchanged)
+        struct PersistedDataV7 {
+            uint32_t magic   = 0x53464231;
+            uint16_t version = 7;
+            MotionConfigV6 cfg;
+            uint32_t faultTotal = 0;
+            uint8_t  lastFaultCode = 0;
+            uint32_t lastFaultUptimeMs = 0;
+            uint32_t resetCount = 0;
+            uint8_t  ledMode = 0;
+            uint8_t  ledManualOn = 1;
+            uint16_t ledOnStartMin = 8*60;
+            uint16_t ledOnEndMin   = 20*60;
+            uint32_t alertSeq = 0;
+            uint8_t  alertHead = 0;
+            uint8_t  alertCount = 0;
+            uint8_t  alertCodes[5] = {0};
+            uint32_t alertUptimeSec[5] = {0};
+            uint32_t factorySeq = 0;
+            uint8_t  factoryLastPass = 0;
+            uint8_t  factoryFailCode = 0;
+            uint8_t  factoryFailStep = 0;
+            uint32_t factoryLastDurationMs = 0;
+            uint32_t factoryLastUptimeSec = 0;
+            uint32_t factoryPassCount = 0;
+            uint32_t factoryFailCount = 0;
+            uint8_t  factoryLogHead = 0;
+            uint8_t  factoryLogCount = 0;
+            uint8_t  factoryLogPass[8] = {0};
+            uint8_t  factoryLogFailCode[8] = {0};
+            uint8_t  factoryLogFailStep[8] = {0};
+            uint16_t factoryLogDurationSec[8] = {0};
+            uint32_t factoryLogUptimeSec[8] = {0};
+            uint32_t factoryLogCycles[8] = {0};
+            uint32_t motionTravelSteps = 0;
+            int32_t  motionParkPos = 0;
+            uint8_t  motionParkValid = 0;
+            uint8_t  motionMicrostepDiv = 0;
+            uint32_t crc = 0;
+        };
+        PersistedDataV7 v7;
+        EEPROM.get(0, v7);
+        if (!crcMatches(v7)) return false;
+        out = PersistedData{};
+        out.magic = v7.magic;
+        out.version = 9;
+        migrateCfgV6(out.cfg, v7.cfg);
+        copyCommonV5(out, v7);
+        out.motionTravelSteps = v7.motionTravelSteps;
+        out.motionParkPos = v7.motionParkPos;
+        out.motionParkValid = v7.motionParkValid;
+        out.motionMicrostepDiv = v7.motionMicrostepDiv;
+        return true;
+    }
+
+    if (version == 8) {
+        // v8 -> v9 migration (MotionConfig gains the speed zone table; rest unchanged)
+        struct PersistedDataV8 {
+            uint32_t magic   = 0x53464231;
+            uint16_t version = 8;
+            MotionConfigV8 cfg;
+            uint32_t faultTotal = 0;
+            uint8_t  lastFaultCode = 0;
+            uint32_t lastFaultUptimeMs = 0;
+            uint32_t resetCount = 0;
+            uint8_t  ledMode = 0;
+            uint8_t  ledManualOn = 1;
+            uint16_t ledOnStartMin = 8*60;
+            uint16_t ledOnEndMin   = 20*60;
+            uint32_t alertSeq = 0;
+            uint8_t  alertHead = 0;
+            uint8_t  alertCount = 0;
+            uint8_t  alertCodes[5] = {0};
+            uint32_t alertUptimeSec[5] = {0};
+            uint32_t factorySeq = 0;
+            uint8_t  factoryLastPass = 0;
+            uint8_t  factoryFailCode = 0;
+            uint8_t  factoryFailStep = 0;
+            uint32_t factoryLastDurationMs = 0;
+            uint32_t factoryLastUptimeSec = 0;
+            uint32_t factoryPassCount = 0;
+            uint32_t factoryFailCount = 0;
+            uint8_t  factoryLogHead = 0;
+            uint8_t  factoryLogCount = 0;
+            uint8_t  factoryLogPass[8] = {0};
+            uint8_t  factoryLogFailCode[8] = {0};
+            uint8_t  factoryLogFailStep[8] = {0};
+            uint16_t factoryLogDurationSec[8] = {0};
+            uint32_t factoryLogUptimeSec[8] = {0};
+            uint32_t factoryLogCycles[8] = {0};
+            uint32_t motionTravelSteps = 0;
+            int32_t  motionParkPos = 0;
+            uint8_t  motionParkValid = 0;
+            uint8_t  motionMicrostepDiv = 0;
+            uint32_t crc = 0;
+        };
+        PersistedDataV8 v8;
+        EEPROM.get(0, v8);
+        if (!crcMatches(v8)) return false;
+        out = PersistedData{};
+        out.magic = v8.magic;
+        out.version = 9;
+        migrateCfgV8(out.cfg, v8.cfg);
+        copyCommonV5(out, v8);
+        out.motionTravelSteps = v8.motionTravelSteps;
+        out.motionParkPos = v8.motionParkPos;
+        out.motionParkValid = v8.motionParkValid;
+        out.motionMicrostepDiv = v8.motionMicrostepDiv;
+        return true;
+    }
+
+    if (version != 9) return false;
 
     EEPROM.get(0, out);
     return (calcCRC(out) == out.crc);
 }
 
 void SettingsStore::save(PersistedData in) {
+    PROF_SCOPE(ProfPhase::StoreSave);
     in.crc = calcCRC(in);
     EEPROM.put(0, in);
     EEPROM.commit();
 }
+
+bool SettingsStore::loadChannel(uint8_t ch, PersistedChannel& out) {
+    if (ch == 0 || channelOffset(ch) + sizeof(PersistedChannel) > EEPROM_SIZE) return false;
+    PersistedChannel c;
+    EEPROM.get(channelOffset(ch), c);
+    if (c.magic != 0x53464243 || c.version != 1 || c.channel != ch) return false;
+    if (!crcMatches(c)) return false;
+    out = c;
+    return true;
+}
+
+void SettingsStore::saveChannel(PersistedChannel in) {
+    if (in.channel == 0 || channelOffset(in.channel) + sizeof(PersistedChannel) > EEPROM_SIZE) return;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&in);
+    uint32_t crc = 0;
+    for (size_t i = 0; i < sizeof(PersistedChannel) - sizeof(uint32_t); i++) {
+        crc = (crc * 33u) ^ p[i];
+    }
+    in.crc = crc;
+    PROF_SCOPE(ProfPhase::StoreSave);
+    EEPROM.put(channelOffset(in.channel), in);
+    EEPROM.commit();
+}
@@ -5,7 +5,7 @@
 
 struct PersistedData {
     uint32_t magic   = 0x53464231; // "SFB1"
-    uint16_t version = 5;
+    uint16_t version = 9;
 
     MotionConfig cfg;
 
@@ -47,17 +47,47 @@ struct PersistedData {
     uint32_t factoryLogUptimeSec[8] = {0};
     uint32_t factoryLogCycles[8] = {0};
 
+    // Learned motion geometry for warm start (MotionController::applyPersistedMotion)
+    uint32_t motionTravelSteps = 0;   // 0 = never calibrated
+    int32_t  motionParkPos = 0;       // pos at the last controlled stop
+    uint8_t  motionParkValid = 0;     // 1 = parked at motionParkPos (cleared once motion resumes)
+    uint8_t  motionMicrostepDiv = 0;  // microstep the steps above were counted in
+
+    uint32_t crc = 0;
+};
+
+// Motion settings of an extra bed channel (MOTION_CHANNELS > 1). Channel 0 keeps
+// living in PersistedData; channel n >= 1 has its own slot after it.
+struct PersistedChannel {
+    uint32_t magic   = 0x53464243; // "SFBC"
+    uint16_t version = 1;
+    uint8_t  channel = 0;
+
+    MotionConfig cfg;
+
+    uint32_t motionTravelSteps = 0;
+    int32_t  motionParkPos = 0;
+    uint8_t  motionParkValid = 0;
+    uint8_t  motionMicrostepDiv = 0;
+
     uint32_t crc = 0;
 };
 
 class SettingsStore {
 public:
     static constexpr size_t EEPROM_SIZE = 1024;
+    static constexpr size_t CHANNEL_BASE = 512;   // PersistedData stays below this
+    static constexpr size_t CHANNEL_SLOT = 128;
 
     void begin() { EEPROM.begin(EEPROM_SIZE); }
     bool load(PersistedData& out);
     void save(PersistedData in);
 
+    // ch >= 1 only; false for channel 0, an empty slot or a bad CRC.
+    bool loadChannel(uint8_t ch, PersistedChannel& out);
+    void saveChannel(PersistedChannel in);
+
 private:
     uint32_t calcCRC(const PersistedData& d);
+    static size_t channelOffset(uint8_t ch) { return CHANNEL_BASE + (size_t)(ch - 1) * CHANNEL_SLOT; }
 };
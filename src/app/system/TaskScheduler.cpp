@@ -0,0 +1,133 @@
+#include "TaskScheduler.h"
+
+int8_t TaskScheduler::addPeriodic(const char* name, TaskFn fn, uint32_t periodMs,
+                                  uint8_t priority, uint32_t budgetUs) {
+    return add(name, fn, periodMs, priority, budgetUs, false);
+}
+
+int8_t TaskScheduler::addOneShot(const char* name, TaskFn fn, uint8_t priority, uint32_t budgetUs) {
+    return add(name, fn, 0, priority, budgetUs, true);
+}
+
+int8_t TaskScheduler::add(const char* name, TaskFn fn, uint32_t periodMs, uint8_t priority,
+                          uint32_t budgetUs, bool oneShot) {
+    if (n >= kMaxTasks || !fn) return -1;
+    Task& t = tasks[n];
+    t = Task{};
+    t.name = name;
+    t.fn = fn;
+    t.periodMs = periodMs;
+    t.priority = priority;
+    t.budgetUs = budgetUs;
+    t.oneShot = oneShot;
+    t.armed = !oneShot;
+    t.releaseMs = millis();
+    return (int8_t)n++;
+}
+
+void TaskScheduler::arm(int8_t id, uint32_t delayMs) {
+    if (id < 0 || id >= (int8_t)n || !tasks[id].oneShot) return;
+    tasks[id].armed = true;
+    tasks[id].releaseMs = millis() + delayMs;
+}
+
+void TaskScheduler::resetStats() {
+    for (uint8_t i = 0; i < n; i++) {
+        Task& t = tasks[i];
+        t.runs = t.overruns = t.misses = 0;
+        t.execLastUs = t.execMaxUs = t.lateMaxMs = 0;
+    }
+}
+
+void TaskScheduler::runTask(uint8_t id, uint32_t nowMs) {
+    Task& t = tasks[id];
+
+    if (t.periodMs != kEveryPass || t.oneShot) {
+        const uint32_t late = nowMs - t.releaseMs;
+        if (late > t.lateMaxMs) t.lateMaxMs = late;
+    }
+
+    const uint32_t t0 = micros();
+    t.fn(nowMs);
+    const uint32_t exec = micros() - t0;
+
+    t.runs++;
+    t.execLastUs = exec;
+    if (exec > t.execMaxUs) t.execMaxUs = exec;
+    if (t.budgetUs > 0 && exec > t.budgetUs) t.overruns++;
+
+    if (t.oneShot) {
+        t.armed = false;
+    } else if (t.periodMs != kEveryPass) {
+        t.releaseMs += t.periodMs;
+        // already past the next release: that one is missed, restart the grid from now
+        if ((int32_t)(millis() - t.releaseMs) >= (int32_t)t.periodMs) {
+            t.misses++;
+            t.releaseMs = millis();
+        }
+    }
+}
+
+void TaskScheduler::runEveryPass() {
+    // few tasks: pick by priority each time instead of keeping a sorted list
+    uint32_t done = 0;
+    for (;;) {
+        int8_t best = -1;
+        for (uint8_t i = 0; i < n; i++) {
+            const Task& t = tasks[i];
+            if (t.oneShot || t.periodMs != kEveryPass || (done & (1u << i))) continue;
+            if (best < 0 || t.priority > tasks[best].priority) best = (int8_t)i;
+        }
+        if (best < 0) return;
+        done |= 1u << best;
+        runTask((uint8_t)best, millis());
+    }
+}
+
+int8_t TaskScheduler::pickDue(uint32_t nowMs, uint32_t done) const {
+    int8_t best = -1;
+    int32_t bestSlack = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        const Task& t = tasks[i];
+        if (!t.armed || (done & (1u << i))) continue;
+        if (!t.oneShot && t.periodMs == kEveryPass) continue;
+        if ((int32_t)(nowMs - t.releaseMs) < 0) continue;   // not released yet
+
+        // deadline = next release (one-shots: their release)
+        const uint32_t deadline = t.releaseMs + (t.oneShot ? 0 : t.periodMs);
+        const int32_t slack = (int32_t)(deadline - nowMs);
+        if (best < 0 || t.priority > tasks[best].priority ||
+            (t.priority == tasks[best].priority && slack < bestSlack)) {
+            best = (int8_t)i;
+            bestSlack = slack;
+        }
+    }
+    return best;
+}
+
+void TaskScheduler::runPass() {
+    runEveryPass();
+
+    uint32_t done = 0;
+    for (;;) {
+        const uint32_t nowMs = millis();
+        const int8_t id = pickDue(nowMs, done);
+        if (id < 0) return;
+        done |= 1u << id;
+        runTask((uint8_t)id, nowMs);
+        runEveryPass();   // keep motion within one job of latency
+    }
+}
+
+uint32_t TaskScheduler::msUntilNextDue() const {
+    const uint32_t nowMs = millis();
+    uint32_t wait = UINT32_MAX;
+    for (uint8_t i = 0; i < n; i++) {
+        const Task& t = tasks[i];
+        if (!t.armed || (!t.oneShot && t.periodMs == kEveryPass)) continue;
+        const int32_t left = (int32_t)(t.releaseMs - nowMs);
+        if (left <= 0) return 0;
+        if ((uint32_t)left < wait) wait = (uint32_t)left;
+    }
+    return wait;
+}
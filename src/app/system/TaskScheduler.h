@@ -0,0 +1,68 @@
+#pragma once
+#include <Arduino.h>
+
+// Cooperative, deadline-based scheduler for the core0 loop (static task table, no heap).
+//
+// - period > 0: released every periodMs; the deadline of a release is the next one.
+//   A task that falls a whole period behind counts a miss and restarts its grid from
+//   now (no burst of catch-up runs).
+// - period == kEveryPass: latency-critical work (motion). Runs at the start of every
+//   pass and again between any two other tasks, so a long job delays it by one job at most.
+// - one-shot: idle until arm(); arm() again before it runs pushes it back (debounce).
+//
+// Among the due tasks the highest priority runs first, ties go to the earliest deadline.
+// Each run is timed against its budget (overruns) and its release (lateness).
+class TaskScheduler {
+public:
+    using TaskFn = void(*)(uint32_t nowMs);
+
+    static constexpr uint8_t kMaxTasks = 12;
+    static constexpr uint32_t kEveryPass = 0;
+
+    struct Task {
+        const char* name = nullptr;
+        TaskFn fn = nullptr;
+        uint32_t periodMs = 0;
+        uint8_t priority = 0;        // higher runs first
+        uint32_t budgetUs = 0;       // 0 = no budget
+        bool oneShot = false;
+        bool armed = false;          // periodic tasks are always armed
+        uint32_t releaseMs = 0;      // current release (due time)
+
+        uint32_t runs = 0;
+        uint32_t overruns = 0;       // runs longer than budgetUs
+        uint32_t misses = 0;         // releases skipped because the previous one ran late
+        uint32_t execLastUs = 0;
+        uint32_t execMaxUs = 0;
+        uint32_t lateMaxMs = 0;      // start - release
+    };
+
+    // Returns the task id, or -1 if the table is full.
+    int8_t addPeriodic(const char* name, TaskFn fn, uint32_t periodMs, uint8_t priority,
+                       uint32_t budgetUs);
+    int8_t addOneShot(const char* name, TaskFn fn, uint8_t priority, uint32_t budgetUs);
+
+    // One-shot: run once delayMs from now (re-arming moves the deadline).
+    void arm(int8_t id, uint32_t delayMs);
+
+    // One scheduling pass; call from loop().
+    void runPass();
+    // ms until the next periodic release or armed one-shot (0 = one is due now).
+    // Every-pass tasks don't count: their owners report their own idle time.
+    uint32_t msUntilNextDue() const;
+
+    uint8_t count() const { return n; }
+    const Task& task(uint8_t id) const { return tasks[id]; }
+    void resetStats();
+
+private:
+    int8_t add(const char* name, TaskFn fn, uint32_t periodMs, uint8_t priority,
+               uint32_t budgetUs, bool oneShot);
+    void runTask(uint8_t id, uint32_t nowMs);
+    void runEveryPass();
+    // Due task not run yet in this pass (bit per id in `done`), or -1.
+    int8_t pickDue(uint32_t nowMs, uint32_t done) const;
+
+    Task tasks[kMaxTasks];
+    uint8_t n = 0;
+};
@@ -5,7 +5,9 @@
 
 #include "../../config/PinMap.h"
 #include "../../config/Defaults.h"
+#include "../../config/Features.h"
 #include "../controllers/MotionController.h"
+#include "../system/LoopProfiler.h"
 #include "UiRenderer_U8g2.h"
 
 // defined in main.cpp
@@ -17,7 +19,9 @@ extern void markPersistDirty();
 
 struct UiController::Impl {
     UiConfig cfg{};
-    MotionController* motion = nullptr;
+    MotionController* motion = nullptr;   // channel 0
+    MotionController* beds[UiController::kMaxBeds] = {};
+    uint8_t bedCount = 0;
     UiRenderer_U8g2 renderer;
 
     // env
@@ -33,7 +37,7 @@ struct UiController::Impl {
     uint8_t page = 0;
 
     // edit state
-    enum class EditKind : uint8_t { None=0, MaxSpeed, Accel, Dwell, Rehome, LedOnStart, LedOnEnd };
+    enum class EditKind : uint8_t { None=0, MaxSpeed, Accel, Dwell, Rehome, LedOnStart, LedOnEnd, Jerk, Settle };
     EditKind editKind = EditKind::None;
     const char* editLabel = nullptr;
     const char* editUnit = nullptr;
@@ -113,15 +117,15 @@ struct UiController::Impl {
     } factory;
 
     static constexpr uint8_t PAGE_MAIN_MAX = 2; // 0..2
-    static constexpr uint8_t PAGE_DIAG_MAX = 5; // 0..5 (Factory Log)
+    static constexpr uint8_t PAGE_DIAG_MAX = 9; // 0..9 (Auto Tune, loop profiler x2, step jitter)
 
     static constexpr uint8_t ROOT_COUNT   = 5;
     static constexpr uint8_t MOTION_COUNT = 3;
-    static constexpr uint8_t PARAM_COUNT  = 4;
+    static constexpr uint8_t PARAM_COUNT  = 8;
     static constexpr uint8_t SYS_COUNT    = 4;
     static constexpr uint8_t LED_COUNT    = 5;
     static constexpr uint8_t TEST_COUNT   = 7;
-    static constexpr uint8_t ENG_COUNT    = 4;
+    static constexpr uint8_t ENG_COUNT    = 5;
 
     // ---- helpers ----
     static int32_t clampi(int32_t v, int32_t lo, int32_t hi) {
@@ -163,6 +167,7 @@ struct UiController::Impl {
     }
 
     void readEnv() {
+        PROF_SCOPE(ProfPhase::UiSensor);
         if (!envOk) { envValid = false; return; }
         sensors_event_t hum, temp;
         if (aht.getEvent(&hum, &temp)) {
@@ -181,6 +186,8 @@ struct UiController::Impl {
             case EditKind::Accel:    return 50;
             case EditKind::Dwell:    return 25;
             case EditKind::Rehome:   return 1;
+            case EditKind::Jerk:     return 500;
+            case EditKind::Settle:   return 10;
             case EditKind::LedOnStart: return 5;
             case EditKind::LedOnEnd:   return 5;
             default: break;
@@ -429,7 +436,7 @@ struct UiController::Impl {
                 editLabel = "최대 속도";
                 editValue = (int32_t)mc.maxSps;
                 editMin = 200;
-                editMax = 2500;
+                editMax = MOTION_SPS_EDIT_MAX;
                 editUnit = "";
                 break;
             case 1:
@@ -456,13 +463,57 @@ struct UiController::Impl {
                 editMax = 500;
                 editUnit = "";
                 break;
+            case 4:
+                // Profile is a toggle (TRAP <-> S-curve), no edit screen
+                motion->requestSetProfile(mc.profile == MotionProfile::SCurve ? MotionProfile::Trapezoid
+                                                                              : MotionProfile::SCurve);
+                markPersistDirty();
+                return;
+            case 5:
+                editKind = EditKind::Jerk;
+                editLabel = "저크";
+                editValue = (int32_t)mc.jerk;
+                editMin = 1000;
+                editMax = 60000;
+                editUnit = "";
+                break;
+            case 6:
+                // Reversal is a toggle (DWELL <-> CONT), no edit screen
+                motion->requestSetReversal(mc.reversal == ReversalMode::Continuous ? ReversalMode::Dwell
+                                                                                   : ReversalMode::Continuous);
+                markPersistDirty();
+                return;
+            case 7:
+                editKind = EditKind::Settle;
+                editLabel = "반전 안정";
+                editValue = (int32_t)mc.reverseSettleMs;
+                editMin = 0;
+                editMax = 1000;
+                editUnit = "ms";
+                break;
         }
 
         gotoScreen(UiScreen::EditValue, 0, 0);
     }
 
+    // LED policy is shared by every bed; the LED menu shows channel 0's copy.
+    void ledModeAuto() {
+        for (uint8_t i = 0; i < bedCount; i++) beds[i]->setLedModeAuto();
+    }
+    void ledModeManual(bool on) {
+        for (uint8_t i = 0; i < bedCount; i++) beds[i]->setLedModeManual(on);
+    }
+    void ledSchedule(uint16_t onStartMin, uint16_t onEndMin) {
+        for (uint8_t i = 0; i < bedCount; i++) beds[i]->setLedScheduleMinutes(onStartMin, onEndMin);
+    }
+    void startAllBeds() {
+        for (uint8_t i = 0; i < bedCount; i++) beds[i]->requestStart();
+    }
+
     void commitEdit() {
         if (!motion) return;
+        // Motion parameters are per channel: the menus edit channel 0 only (others over BedLink).
+        // LED policy is shared and goes through the led*() helpers to every bed.
 
         const auto& stNow = motion->status();
 
@@ -471,13 +522,15 @@ struct UiController::Impl {
             case EditKind::Accel:    motion->requestSetAccel((float)editValue); break;
             case EditKind::Dwell:    motion->requestSetDwell((uint32_t)editValue); break;
             case EditKind::Rehome:   motion->requestSetRehomeEvery((uint32_t)editValue); break;
+            case EditKind::Jerk:     motion->requestSetJerk((float)editValue); break;
+            case EditKind::Settle:   motion->requestSetReverseSettle((uint32_t)editValue); break;
             case EditKind::LedOnStart:
-                motion->setLedModeAuto();
-                motion->setLedScheduleMinutes((uint16_t)editValue, stNow.ledOnEndMin);
+                ledModeAuto();
+                ledSchedule((uint16_t)editValue, stNow.ledOnEndMin);
                 break;
             case EditKind::LedOnEnd:
-                motion->setLedModeAuto();
-                motion->setLedScheduleMinutes(stNow.ledOnStartMin, (uint16_t)editValue);
+                ledModeAuto();
+                ledSchedule(stNow.ledOnStartMin, (uint16_t)editValue);
                 break;
             default: break;
         }
@@ -507,7 +560,8 @@ struct UiController::Impl {
 
         // LED policy check: moving states must have LED ON (motor enable condition)
         if ((st.state == MotionState::HomingLeft || st.state == MotionState::CalibMoveRight ||
-             st.state == MotionState::MoveLeft  || st.state == MotionState::MoveRight) &&
+             st.state == MotionState::MoveLeft  || st.state == MotionState::MoveRight ||
+             st.state == MotionState::HomingSeek || st.state == MotionState::HomingBackoff) &&
             !st.ledOn) {
             stopFactoryValidation(true, 201); // LED policy violation
             return;
@@ -516,9 +570,9 @@ struct UiController::Impl {
         switch (cursor) {
             case 0: {
                 if (st.ledMode == LedMode::Auto) {
-                    motion->setLedModeManual(st.ledManualOn);
+                    ledModeManual(st.ledManualOn);
                 } else {
-                    motion->setLedModeAuto();
+                    ledModeAuto();
                 }
                 // persist LED settings
                 markPersistDirty();
@@ -526,10 +580,10 @@ struct UiController::Impl {
             }
             case 1: {
                 bool next = !st.ledManualOn;
-                motion->setLedModeManual(next);
+                ledModeManual(next);
                 markPersistDirty();
 
-                if (next) motion->requestStart();   // ✅ ON이면 바로 구동
+                if (next) startAllBeds();   // ✅ ON이면 바로 구동
                 break;
             }
             case 2: {
@@ -568,6 +622,13 @@ struct UiController::Impl {
             case 1: motion->requestForceMoveLeft(); break;
             case 2: motion->requestForceMoveRight(); break;
             case 3: motion->requestDisableMotor(); break;
+            case 4:
+                // toggle (channel 0; other channels tune over BedLink ML_AUTO_TUNE);
+                // the result shows on Diag page 7 and is saved by main.cpp
+                if (motion->status().autoTuneRunning) motion->stopAutoTune();
+                else motion->startAutoTune();
+                gotoScreen(UiScreen::MenuDiag, 0, 6);
+                return;
         }
 
         // Policy: after engineering action, go back to Main (safer)
@@ -579,17 +640,17 @@ struct UiController::Impl {
 
         switch (cursor) {
             case 0: // LED ON
-                motion->setLedModeManual(true);
+                ledModeManual(true);
                 markPersistDirty();
 
                 // ✅ LED ON은 모터 Enable 조건이므로,
                 // "움직여야 한다" 정책이면 Start도 같이 요청해야 함
-                motion->requestStart();
+                startAllBeds();
 
                 showToast("TEST", "LED ON", "OK");
                 break;
             case 1: // LED OFF
-                motion->setLedModeManual(false);
+                ledModeManual(false);
                 markPersistDirty();
                 showToast("TEST", "LED OFF", "OK");
                 break;
@@ -677,7 +738,8 @@ struct UiController::Impl {
 
         // LED policy check: moving states must have LED ON (motor enable condition)
         if ((st.state == MotionState::HomingLeft || st.state == MotionState::CalibMoveRight ||
-             st.state == MotionState::MoveLeft  || st.state == MotionState::MoveRight) &&
+             st.state == MotionState::MoveLeft  || st.state == MotionState::MoveRight ||
+             st.state == MotionState::HomingSeek || st.state == MotionState::HomingBackoff) &&
             !st.ledOn) {
             stopFactoryValidation(true, 201); // LED policy violation
             return;
@@ -699,15 +761,17 @@ struct UiController::Impl {
         // so this runs on bench without real sensors.
         switch (factory.step) {
             case FactoryStep::Start: {
-                motion->requestStop();
-                motion->requestStart();
+                // full homing + calibration: a warm start would skip the steps under test
+                motion->requestRecalibrate();
                 advance(FactoryStep::WaitHoming);
                 break;
             }
 
             case FactoryStep::WaitHoming: {
-                // Expect HomingLeft then move to CalibMoveRight
-                if (st.state == MotionState::HomingLeft) {
+                // Expect HomingSeek/HomingLeft then move to CalibMoveRight.
+                // A fast seek backs off the hall, so re-inject for the slow approach.
+                if (st.state == MotionState::HomingBackoff) factory.injectedEnds = 0;
+                if (st.state == MotionState::HomingLeft || st.state == MotionState::HomingSeek) {
                     if (!factory.injectedEnds && (now - factory.stepStartMs) > 600) {
                         motion->requestSimulateHallLeft(250);
                         factory.injectedEnds = 1;
@@ -809,7 +873,8 @@ struct UiController::Impl {
             }
 
             case FactoryStep::WaitRecoverHoming: {
-                if (st.state == MotionState::HomingLeft) {
+                if (st.state == MotionState::HomingBackoff) factory.injectedEnds = 0;
+                if (st.state == MotionState::HomingLeft || st.state == MotionState::HomingSeek) {
                     if (!factory.injectedEnds && (now - factory.stepStartMs) > 600) {
                         motion->requestSimulateHallLeft(250);
                         factory.injectedEnds = 1;
@@ -851,6 +916,24 @@ struct UiController::Impl {
         // do not auto-clear factory.done so the result can be shown
     }
 
+    // -----------------------------
+    // idle hint (tickless loop)
+    // -----------------------------
+    static uint32_t msLeft(uint32_t elapsed, uint32_t period) {
+        return (elapsed >= period) ? 0 : period - elapsed;
+    }
+
+    uint32_t msUntilNextTick() const {
+        if (screen == UiScreen::TestRunning) return 0;   // validation steps are judged every tick
+        const uint32_t now = millis();
+        uint32_t wait = msLeft(now - lastBlinkMs, 500);
+        const uint32_t sensor = msLeft(now - lastSensorMs, cfg.sensorMs);
+        const uint32_t draw = msLeft(now - lastDrawMs, cfg.refreshMs);
+        if (sensor < wait) wait = sensor;
+        if (draw < wait) wait = draw;
+        return wait;
+    }
+
     // -----------------------------
     // main tick
     // -----------------------------
@@ -892,6 +975,7 @@ struct UiController::Impl {
         if (now - lastDrawMs < cfg.refreshMs) return;
         lastDrawMs = now;
 
+        PROF_BEGIN(vmBuild, ProfPhase::UiViewModel);
         UiViewModel vm;
         vm.envValid = envValid;
         vm.tempC = tempC;
@@ -980,6 +1064,7 @@ struct UiController::Impl {
             vm.faultCode = static_cast<uint8_t>(motion->status().err);
             vm.retryCount = motion->status().recoverAttempts;
             mapFault(vm);
+            PROF_END(vmBuild);
             renderer.draw(vm);
             return; // 🔥 IMPORTANT: ignore other UI screens while fault
         }
@@ -993,6 +1078,17 @@ struct UiController::Impl {
             vm.editAsTime = (editKind == EditKind::LedOnStart || editKind == EditKind::LedOnEnd);
         }
 
+#if LOOP_PROFILER
+        if (screen == UiScreen::MenuDiag && page >= 7) {
+            for (uint8_t i = 0; i < LoopProfiler::kPhases; i++) {
+                const LoopProfiler::PhaseStats& ps = LoopProfiler::stats((ProfPhase)i);
+                vm.profAvgUs[i] = LoopProfiler::toUs(LoopProfiler::avgCyc(ps));
+                vm.profMaxUs[i] = LoopProfiler::toUs(ps.maxCyc);
+            }
+        }
+#endif
+
+        PROF_END(vmBuild);
         renderer.draw(vm);
     }
 
@@ -1033,9 +1129,11 @@ struct UiController::Impl {
 UiController::UiController() : _(new Impl()) {}
 UiController::~UiController() { delete _; }
 
-void UiController::begin(const UiConfig& cfg, MotionController* motion) {
+void UiController::begin(const UiConfig& cfg, MotionController* const* motions, uint8_t count) {
     _->cfg = cfg;
-    _->motion = motion;
+    _->bedCount = (count > kMaxBeds) ? kMaxBeds : count;
+    for (uint8_t i = 0; i < _->bedCount; i++) _->beds[i] = motions[i];
+    _->motion = _->bedCount ? motions[0] : nullptr;
 
     Wire.setSDA(PIN_I2C_SDA);
     Wire.setSCL(PIN_I2C_SCL);
@@ -1062,3 +1160,7 @@ void UiController::handleEncoder(const EncoderEvents& e) {
 void UiController::tick() {
     _->tick();
 }
+
+uint32_t UiController::msUntilNextTick() const {
+    return _->msUntilNextTick();
+}
@@ -14,9 +14,16 @@ public:
     UiController();
     ~UiController();
 
-    void begin(const UiConfig& cfg, MotionController* motion);
+    static constexpr uint8_t kMaxBeds = 3;
+
+    void begin(const UiConfig& cfg, MotionController* motion) { begin(cfg, &motion, 1); }
+    // The menus drive motions[0] (motion parameters, auto tune and engineering actions are
+    // per channel); LED policy edits (one grow-light schedule) go to every bed.
+    void begin(const UiConfig& cfg, MotionController* const* motions, uint8_t count);
     void handleEncoder(const EncoderEvents& e);
     void tick();
+    // ms until tick() has something due (blink, sensor read, redraw); 0 while a test runs.
+    uint32_t msUntilNextTick() const;
 
 private:
     struct Impl;
@@ -1,6 +1,7 @@
 #pragma once
 #include <Arduino.h>
 #include "../controllers/MotionController.h"
+#include "../system/LoopProfiler.h"
 
 enum class UiScreen : uint8_t {
     Main = 0,
@@ -90,4 +91,8 @@ struct UiViewModel {
     bool factoryAutoRunning = false;
     uint16_t factoryAutoProgress = 0;
     uint16_t factoryAutoTarget = 0;
+
+    // loop profiler (Diag pages 8..9), per ProfPhase; filled only with LOOP_PROFILER
+    uint32_t profAvgUs[LoopProfiler::kPhases] = {};
+    uint32_t profMaxUs[LoopProfiler::kPhases] = {};
 };
\ No newline at end of file
@@ -25,6 +25,7 @@ void UiRenderer_U8g2::draw(const UiViewModel& vm) {
         return;
     }
 
+    PROF_BEGIN(render, ProfPhase::UiRender);
     u8g2.clearBuffer();
     u8g2.setDrawColor(1);
 
@@ -47,6 +48,9 @@ void UiRenderer_U8g2::draw(const UiViewModel& vm) {
     }
 
     u8g2.setDrawColor(1);
+    PROF_END(render);
+
+    PROF_SCOPE(ProfPhase::UiSendBuffer);
     u8g2.sendBuffer();
 }
 
@@ -152,6 +156,7 @@ void UiRenderer_U8g2::drawBody(const UiViewModel& vm) {
 /* ---------------- Fault ---------------- */
 
 void UiRenderer_U8g2::drawFaultFullScreen(const UiViewModel& vm) {
+    PROF_BEGIN(render, ProfPhase::UiRender);
     u8g2.clearBuffer();
 
     u8g2.setDrawColor(1);
@@ -173,7 +178,9 @@ void UiRenderer_U8g2::drawFaultFullScreen(const UiViewModel& vm) {
     u8g2.drawStr(10, 50, retry);
 
     if (vm.blink) u8g2.drawStr(70, 50, "Hold to reset");
+    PROF_END(render);
 
+    PROF_SCOPE(ProfPhase::UiSendBuffer);
     u8g2.sendBuffer();
 }
 
@@ -238,10 +245,15 @@ void UiRenderer_U8g2::drawFooter(const UiViewModel& vm) {
     switch (vm.st.state) {
         case MotionState::MoveRight:        motIco = M_RIGHT; break;
         case MotionState::MoveLeft:         motIco = M_LEFT;  break;
-        case MotionState::Dwell:            motIco = M_STOP;  break;
+        case MotionState::Dwell:
+        case MotionState::Stopping:         motIco = M_STOP;  break;
+        case MotionState::HomingSeek:
+        case MotionState::HomingBackoff:
         case MotionState::HomingLeft:
         case MotionState::CalibMoveRight:   motIco = M_STOP; motCh[0] = 'H'; break;
         case MotionState::Fault:            motIco = M_STOP; motCh[0] = '!'; break;
+        case MotionState::ProgramMove:
+        case MotionState::ProgramHold:      motIco = M_STOP; motCh[0] = 'P'; break;
         case MotionState::RecoverWait:
         case MotionState::Stopped:          motIco = M_STOP; break;
         default: break;
@@ -348,14 +360,18 @@ void UiRenderer_U8g2::drawMenuMotion(const UiViewModel& vm) {
 void UiRenderer_U8g2::drawMenuParams(const UiViewModel& vm) {
     drawMenuHeader(vm, "Parameters");
 
-    char b0[24], b1[24], b2[24], b3[24];
+    char b0[24], b1[24], b2[24], b3[24], b4[24], b5[24], b6[24], b7[24];
     snprintf(b0, sizeof(b0), "MaxSps: %d", (int)vm.cfg.maxSps);
     snprintf(b1, sizeof(b1), "Accel : %d", (int)vm.cfg.accel);
     snprintf(b2, sizeof(b2), "Dwell : %dms", (int)vm.cfg.dwellMs);
     snprintf(b3, sizeof(b3), "Rehome: %d", (int)vm.cfg.rehomeEveryCycles);
+    snprintf(b4, sizeof(b4), "Profile: %s", vm.cfg.profile == MotionProfile::SCurve ? "S-CURVE" : "TRAP");
+    snprintf(b5, sizeof(b5), "Jerk  : %d", (int)vm.cfg.jerk);
+    snprintf(b6, sizeof(b6), "Reverse: %s", vm.cfg.reversal == ReversalMode::Continuous ? "CONT" : "DWELL");
+    snprintf(b7, sizeof(b7), "Settle: %dms", (int)vm.cfg.reverseSettleMs);
 
-    const char* items[] = { b0, b1, b2, b3 };
-    drawMenuList(items, 4, vm.cursor);
+    const char* items[] = { b0, b1, b2, b3, b4, b5, b6, b7 };
+    drawMenuList(items, 8, vm.cursor);
 }
 
 /* ---------------- Menu: Diagnostics ---------------- */
@@ -451,6 +467,55 @@ void UiRenderer_U8g2::drawMenuDiag(const UiViewModel& vm) {
             }
             break;
         }
+        case 6: {
+            // Auto tune: live stage, then the last result
+            static const char* const kResult[] = { "-", "CEIL", "LOST", "FAULT", "ABORT" };
+            const uint8_t r = (uint8_t)vm.st.autoTuneResult;
+            if (vm.st.autoTuneRunning) {
+                snprintf(l1, sizeof(l1), "AutoTune RUN st:%u", (unsigned)vm.st.autoTuneStage);
+            } else {
+                snprintf(l1, sizeof(l1), "AutoTune #%lu %s", (unsigned long)vm.st.autoTuneSeq,
+                         (r < 5) ? kResult[r] : "?");
+            }
+            snprintf(l2, sizeof(l2), "Pass:%u Lost:%ld",
+                     (unsigned)vm.st.autoTuneStagesPassed, (long)vm.st.autoTuneLostLast);
+            snprintf(l3, sizeof(l3), "Sps  : %d", (int)vm.cfg.maxSps);
+            snprintf(l4, sizeof(l4), "Accel: %d", (int)vm.cfg.accel);
+            break;
+        }
+        case 7:
+        case 8: {
+            // Loop profiler: avg/max us, four phases per page (ProfPhase order)
+#if LOOP_PROFILER
+            char* const out[4] = { l1, l2, l3, l4 };
+            const uint8_t first = (vm.page == 7) ? 0 : 4;
+            for (uint8_t i = 0; i < 4; i++) {
+                const uint8_t ph = first + i;
+                snprintf(out[i], 32, "%-6s %lu/%luus", LoopProfiler::name((ProfPhase)ph),
+                         (unsigned long)vm.profAvgUs[ph], (unsigned long)vm.profMaxUs[ph]);
+            }
+#else
+            snprintf(l1, sizeof(l1), "LOOP_PROFILER=0");
+            snprintf(l2, sizeof(l2), "-");
+            snprintf(l3, sizeof(l3), "-");
+            snprintf(l4, sizeof(l4), "-");
+#endif
+            break;
+        }
+        case 9: {
+            // Step jitter: worst deviation (+ late) and where it happened, steps that went out
+            // 1 ms or more off their commanded interval (bins 8..), time lost to late steps
+            uint32_t stalls = 0;
+            for (uint8_t b = 8; b < MotionStatus::kStepJitterBins; b++) stalls += vm.st.stepJitterHist[b];
+            snprintf(l1, sizeof(l1), "Jitter n:%lu", (unsigned long)vm.st.stepJitterSamples);
+            snprintf(l2, sizeof(l2), "Worst %+ldus st:%u", (long)vm.st.stepJitterWorstUs,
+                     (unsigned)vm.st.stepJitterWorstState);
+            snprintf(l3, sizeof(l3), "Cmd %luus @%lus", (unsigned long)vm.st.stepJitterWorstCmdUs,
+                     (unsigned long)(vm.st.stepJitterWorstMs / 1000));
+            snprintf(l4, sizeof(l4), ">=1ms:%lu lost:%lums", (unsigned long)stalls,
+                     (unsigned long)(vm.st.stepLostUs / 1000));
+            break;
+        }
         default: {
             snprintf(l1, sizeof(l1), "-");
             snprintf(l2, sizeof(l2), "-");
@@ -467,8 +532,8 @@ void UiRenderer_U8g2::drawMenuDiag(const UiViewModel& vm) {
 
     // Page indicator (right-bottom)
     char pbuf[12];
-    snprintf(pbuf, sizeof(pbuf), "%u/6", (unsigned)(vm.page + 1));
-    u8g2.drawStr(106, 63, pbuf);
+    snprintf(pbuf, sizeof(pbuf), "%u/10", (unsigned)(vm.page + 1));
+    u8g2.drawStr(128 - u8g2.getStrWidth(pbuf), 63, pbuf);
 }
 
 /* ---------------- Menu: System ---------------- */
@@ -637,10 +702,11 @@ void UiRenderer_U8g2::drawEngineering(const UiViewModel& vm) {
         "Force Home",
         "Move Left",
         "Move Right",
-        "Disable Motor"
+        "Disable Motor",
+        "Auto Tune"
     };
 
-    drawMenuList(items, 4, vm.cursor);
+    drawMenuList(items, 5, vm.cursor);
 
     u8g2.setFont(u8g2_font_6x10_tf);
     u8g2.drawStr(2, 63, "Click:Run  Long:Back");
@@ -685,9 +751,14 @@ const char* UiRenderer_U8g2::stateText(MotionState s) {
         case MotionState::MoveRight:     return "▶ 우측 이동";
         case MotionState::MoveLeft:      return "◀ 좌측 이동";
         case MotionState::Dwell:         return "■ 대기";
+        case MotionState::HomingSeek:
+        case MotionState::HomingBackoff:
         case MotionState::HomingLeft:    return "H 초기화";
         case MotionState::RecoverWait:   return "복구 대기";
+        case MotionState::Stopping:      return "■ 감속 정지";
         case MotionState::Stopped:       return "□ 정지";
+        case MotionState::ProgramMove:   return "P 프로그램 이동";
+        case MotionState::ProgramHold:   return "P 위치 유지";
         case MotionState::Fault:         return "! 오류";
         default:                         return "";
     }
@@ -700,6 +771,7 @@ const char* UiRenderer_U8g2::errorText(MotionError e) {
         case MotionError::CalibFailed:      return "보정 실패";
         case MotionError::BothLimitsActive: return "양쪽 센서 충돌";
         case MotionError::MotionStall:      return "모터 스톨";
+        case MotionError::PositionWindow:   return "위치 오차 초과";
         case MotionError::None:
         default:                            return "";
     }
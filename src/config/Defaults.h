@@ -2,6 +2,26 @@
 #pragma once
 #include <stdint.h>
 
+enum class MotionProfile : uint8_t {
+    Trapezoid = 0,   // constant accel (instant accel steps)
+    SCurve = 1       // jerk-limited accel
+};
+
+enum class ReversalMode : uint8_t {
+    Dwell = 0,       // stop, disable the driver and wait dwellMs at each end
+    Continuous = 1   // keep the driver enabled, settle reverseSettleMs, reverse
+};
+
+// Cruise speed for one slice of the bed, as permille of the learned travel
+// (0 = left home, 1000 = right end). Unused slots have from >= to.
+struct MotionZone {
+    uint16_t fromPermille = 0;
+    uint16_t toPermille = 0;
+    float sps = 0.0f;            // capped at maxSps, floored at minSps
+};
+
+static constexpr uint8_t kMotionZoneCount = 4;
+
 // 24/365 안정성 우선: 보수적 기본값
 struct MotionConfig {
     float maxSps = 3000.0f;      // max speed (steps/sec)
@@ -11,6 +31,12 @@ struct MotionConfig {
     uint32_t homingTimeoutMs = 15000;
     uint32_t travelTimeoutMs = 25000; // fallback if travelSteps not learned yet
     uint32_t rehomeEveryCycles = 200; // full cycles (L->R->L) then rehome
+    MotionProfile profile = MotionProfile::Trapezoid;
+    float jerk = 3000.0f;        // steps/sec^3 (S-curve only)
+    ReversalMode reversal = ReversalMode::Dwell;
+    uint32_t reverseSettleMs = 0;  // Continuous only (0 = reverse immediately)
+    // Speed map: outside every zone strokes cruise at maxSps; overlaps take the slowest.
+    MotionZone zones[kMotionZoneCount] = {};
 };
 
 struct UiConfig {
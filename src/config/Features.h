@@ -0,0 +1,77 @@
+#pragma once
+
+// Build-time feature selection.
+// Override from platformio.ini build_flags, e.g. -D MOTION_STEP_BACKEND=1
+
+// ---- Step pulse backend ----
+// POLLED: MotionController::tick() bit-bangs STEP whenever stepDue() (legacy path)
+// PIO   : RP2040 PIO state machine consumes a FIFO of step intervals (StepGenHal_Pio)
+// ALARM : timer alarm ISR emits each step and re-arms at the next deadline (StepGenHal_Alarm)
+#define MOTION_STEP_BACKEND_POLLED 0
+#define MOTION_STEP_BACKEND_PIO    1
+#define MOTION_STEP_BACKEND_ALARM  2
+
+#ifndef MOTION_STEP_BACKEND
+#define MOTION_STEP_BACKEND MOTION_STEP_BACKEND_POLLED
+#endif
+
+// Upper bound offered by the Params > MaxSps editor.
+// The polled path cannot hold its rate much above ~3k sps once the UI is busy.
+#ifndef MOTION_SPS_EDIT_MAX
+#if MOTION_STEP_BACKEND == MOTION_STEP_BACKEND_POLLED
+#define MOTION_SPS_EDIT_MAX 2500
+#else
+#define MOTION_SPS_EDIT_MAX 12000
+#endif
+#endif
+
+// ---- Motion core placement ----
+// 0: MotionController::tick() runs from loop() on core0 (legacy)
+// 1: MotionController runs alone in loop1() on core1. UI/SettingsStore/serial stay on core0;
+//    requests cross via MotionController's SPSC command queue, status/events come back.
+#ifndef MOTION_ON_CORE1
+#define MOTION_ON_CORE1 0
+#endif
+
+// ---- Stepper driver HAL ----
+// 1: StepperHal_Sio (direct SIO set/clr, shadowed EN/DIR/MS)  0: StepperHal_Drv8825 (digitalWrite)
+// Stays 0 until embedded/test_stepper_hal has been measured on a board.
+#ifndef MOTION_STEPPER_SIO
+#define MOTION_STEPPER_SIO 0
+#endif
+
+// ---- Hall end-stop input ----
+// 1: GPIO edge interrupts latch micros() + step position into a queue that tick() drains
+//    through a glitch filter (MotionController::setHallGlitchFilterUs)
+// 0: digitalRead() once per tick (legacy)
+#ifndef MOTION_HALL_IRQ
+#define MOTION_HALL_IRQ 1
+#endif
+
+// ---- Tickless core0 loop ----
+// 1: after each scheduler pass core0 sleeps (WFE + timer alarm) until the earliest of the
+//    next task release and the motion/UI/encoder next-wake hints; any IRQ (hall, encoder,
+//    USB serial) wakes it early. 0: loop() spins as before.
+// Stays 0 until idle current and wake latency have been measured on a board; the 10 ms UI
+// task bounds every sleep, so the saving is smaller than the motion idle hints suggest.
+#ifndef LOOP_TICKLESS
+#define LOOP_TICKLESS 0
+#endif
+
+// ---- Loop profiler ----
+// 1: per-phase cycle min/avg/max + log2 histograms (app/system/LoopProfiler) for encoder
+//    poll, motion tick, UI sensor/view-model/render/sendBuffer, settings save and the serial
+//    log. Shown on Diag pages 8..9, printed as [PROF], readable over BedLink.
+// 0: probes compile to nothing.
+#ifndef LOOP_PROFILER
+#define LOOP_PROFILER 0
+#endif
+
+// ---- Bed channels ----
+// Number of MotionController instances (one bed each, pins from kMotionPins[] in PinMap.h).
+// All channels tick from the same loop (core0, or core1 with MOTION_ON_CORE1). The local
+// UI drives channel 0 (its LED policy edits go to all channels); BedLink routes by the
+// envelope channel byte. Max 3.
+#ifndef MOTION_CHANNELS
+#define MOTION_CHANNELS 1
+#endif
@@ -1,5 +1,7 @@
 
 #pragma once
+#include <stdint.h>
+#include "Features.h"
 
 // DRV8825 pins (GPIO numbers on Pico)
 #ifndef PIN_STEP
@@ -22,6 +24,10 @@
 #ifndef PIN_MS3
 #define PIN_MS3       255
 #endif
+// Microstep the driver is strapped to when MS1..MS3 are not connected (1: DRV8825 pull-downs)
+#ifndef MS_STRAP_DIV
+#define MS_STRAP_DIV  1
+#endif
 
 // Hall sensors (active-low): magnet close => LOW
 #ifndef PIN_HALL_LEFT
@@ -55,8 +61,76 @@
 #define PIN_GROW_LED   25
 #endif
 
+// Extra bed channels (MOTION_CHANNELS > 1, see Features.h). 255 = not connected.
+// Defaults leave GPIO 0/1 (UART0) and 6..8 (EC11) free. Extra channels have no MS pins
+// (fixed microstep on the board), so microstep switching stays a channel-0 feature.
+#ifndef PIN_CH1_STEP
+#define PIN_CH1_STEP      9
+#endif
+#ifndef PIN_CH1_DIR
+#define PIN_CH1_DIR       10
+#endif
+#ifndef PIN_CH1_ENABLE
+#define PIN_CH1_ENABLE    11
+#endif
+#ifndef PIN_CH1_HALL_LEFT
+#define PIN_CH1_HALL_LEFT  12
+#endif
+#ifndef PIN_CH1_HALL_RIGHT
+#define PIN_CH1_HALL_RIGHT 13
+#endif
+#ifndef PIN_CH1_GROW_LED
+#define PIN_CH1_GROW_LED   22
+#endif
+
+#ifndef PIN_CH2_STEP
+#define PIN_CH2_STEP      16
+#endif
+#ifndef PIN_CH2_DIR
+#define PIN_CH2_DIR       17
+#endif
+#ifndef PIN_CH2_ENABLE
+#define PIN_CH2_ENABLE    18
+#endif
+#ifndef PIN_CH2_HALL_LEFT
+#define PIN_CH2_HALL_LEFT  19
+#endif
+#ifndef PIN_CH2_HALL_RIGHT
+#define PIN_CH2_HALL_RIGHT 26
+#endif
+#ifndef PIN_CH2_GROW_LED
+#define PIN_CH2_GROW_LED   27
+#endif
+
 // Hall polarity (0 = active-high, 1 = active-low)
 // NOTE: Current v0.2.0 wiring uses INPUT_PULLDOWN, so default is active-high.
 #ifndef HALL_ACTIVE_LOW
 #define HALL_ACTIVE_LOW 0
 #endif
+
+// Pin set of one bed channel (driver + end switches + grow LED). Field names match the
+// StepperHal pin-set concept, so the same struct drives StepperHal_Sio<MotionPins>.
+struct MotionPins {
+    uint8_t step;
+    uint8_t dir;
+    uint8_t enable;
+    uint8_t ms1;
+    uint8_t ms2;
+    uint8_t ms3;
+    uint8_t hallLeft;
+    uint8_t hallRight;
+    uint8_t growLed;
+};
+
+static constexpr MotionPins kMotionPins[] = {
+    { PIN_STEP, PIN_DIR, PIN_ENABLE, PIN_MS1, PIN_MS2, PIN_MS3,
+      PIN_HALL_LEFT, PIN_HALL_RIGHT, PIN_GROW_LED },
+    { PIN_CH1_STEP, PIN_CH1_DIR, PIN_CH1_ENABLE, 255, 255, 255,
+      PIN_CH1_HALL_LEFT, PIN_CH1_HALL_RIGHT, PIN_CH1_GROW_LED },
+    { PIN_CH2_STEP, PIN_CH2_DIR, PIN_CH2_ENABLE, 255, 255, 255,
+      PIN_CH2_HALL_LEFT, PIN_CH2_HALL_RIGHT, PIN_CH2_GROW_LED },
+};
+
+static_assert(MOTION_CHANNELS >= 1 &&
+              MOTION_CHANNELS <= sizeof(kMotionPins) / sizeof(kMotionPins[0]),
+              "MOTION_CHANNELS exceeds the pin table");
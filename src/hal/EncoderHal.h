@@ -13,6 +13,8 @@ public:
 
     virtual void attachABInterrupts(void (*isr)()) = 0;
     virtual void detachABInterrupts() = 0;
+    // Optional: IRQ on button edges, only used to wake an idle loop (default: polled only).
+    virtual void attachBtnInterrupt(void (*isr)()) { (void)isr; }
 
     virtual void enterCritical() = 0;
     virtual void exitCritical() = 0;
@@ -14,4 +14,8 @@ void EncoderHal_Arduino::attachABInterrupts(void (*isr)()) {
 void EncoderHal_Arduino::detachABInterrupts() {
     detachInterrupt(digitalPinToInterrupt(PIN_ENC_A));
     detachInterrupt(digitalPinToInterrupt(PIN_ENC_B));
-}
\ No newline at end of file
+}
+
+void EncoderHal_Arduino::attachBtnInterrupt(void (*isr)()) {
+    attachInterrupt(digitalPinToInterrupt(PIN_ENC_BTN), isr, CHANGE);
+}
@@ -15,6 +15,7 @@ public:
 
     void attachABInterrupts(void (*isr)()) override;
     void detachABInterrupts() override;
+    void attachBtnInterrupt(void (*isr)()) override;
 
     void enterCritical() override { noInterrupts(); }
     void exitCritical() override { interrupts(); }
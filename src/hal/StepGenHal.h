@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+
+// Interval-stream step generator.
+// MotionController pushes the spacing of upcoming STEP pulses and the backend emits
+// them on its own clock (PIO state machine, timer alarm ISR, host mock), so step timing no longer
+// depends on how often loop() reaches MotionController::tick().
+//
+// Each pushed interval produces one STEP pulse immediately, followed by `intervalUs`
+// of idle time before the next queued entry is started.
+class StepGenHal {
+public:
+    virtual ~StepGenHal() = default;
+
+    virtual bool begin() = 0;
+
+    // ---- producer side (MotionController::tick) ----
+    virtual uint16_t freeSlots() const = 0;
+    virtual bool push(uint32_t intervalUs) = 0;
+    virtual uint16_t queued() const = 0;        // pushed but not yet pulsed
+
+    // Pulses that reached the STEP pin since the previous call.
+    virtual uint32_t takeEmitted() = 0;
+    // Pulses emitted since the last takeEmitted(), without consuming them. Safe to call
+    // from an ISR on the core that calls takeEmitted() (hall edge position latch).
+    virtual uint32_t pendingEmitted() const = 0;
+
+    // Stop after the pulse in progress and drop everything still queued.
+    // Pulses emitted before the flush are still reported by the next takeEmitted().
+    virtual void flush() = 0;
+
+    // Worst observed lateness of a pulse against its scheduled time (0 if the
+    // backend is clock-exact, e.g. PIO).
+    virtual uint32_t maxLateUs() const { return 0; }
+    virtual void resetTimingStats() {}
+};
@@ -0,0 +1,97 @@
+#include "StepGenHal_Alarm.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <hardware/gpio.h>
+#include <hardware/timer.h>
+#include <hardware/sync.h>
+
+StepGenHal_Alarm* StepGenHal_Alarm::instances[4] = {};
+
+StepGenHal_Alarm::StepGenHal_Alarm(uint8_t stepPin) : pin(stepPin) {}
+
+bool StepGenHal_Alarm::begin() {
+    const int a = hardware_alarm_claim_unused(false);
+    if (a < 0) return false;
+    alarm = (int8_t)a;
+
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_OUT);
+    gpio_put(pin, 0);
+
+    instances[alarm & 3] = this;
+    hardware_alarm_set_callback((unsigned)alarm, alarmRouter);
+    return true;
+}
+
+bool StepGenHal_Alarm::push(uint32_t intervalUs) {
+    if (alarm < 0) return false;
+    if (intervalUs < kMinIntervalUs) intervalUs = kMinIntervalUs;
+    if (!ring.push(intervalUs)) return false;
+
+    // Idle -> start the stream now. Checked with IRQs off so we can't race the ISR
+    // dropping `running` after it found the ring empty.
+    const uint32_t irqState = save_and_disable_interrupts();
+    if (!running) {
+        running = true;
+        deadlineUs = time_us_64();
+        onAlarm();
+    }
+    restore_interrupts(irqState);
+    return true;
+}
+
+uint32_t StepGenHal_Alarm::takeEmitted() {
+    const uint32_t total = emitted;
+    const uint32_t n = total - reported;
+    reported = total;
+    return n;
+}
+
+void StepGenHal_Alarm::flush() {
+    if (alarm < 0) return;
+    const uint32_t irqState = save_and_disable_interrupts();
+    hardware_alarm_cancel((unsigned)alarm);
+    running = false;
+    ring.clear();
+    gpio_put(pin, 0);
+    restore_interrupts(irqState);
+}
+
+void StepGenHal_Alarm::alarmRouter(unsigned alarmNum) {
+    StepGenHal_Alarm* self = instances[alarmNum & 3];
+    if (self) self->onAlarm();
+}
+
+void StepGenHal_Alarm::pulse() {
+    // DRV8825: STEP high >= 1.9us, low >= 1.9us
+    gpio_put(pin, 1);
+    busy_wait_us_32(3);
+    gpio_put(pin, 0);
+}
+
+void StepGenHal_Alarm::onAlarm() {
+    if (!running) return;
+
+    for (;;) {
+        // Each queued word is one pulse at the current deadline plus the hold-off after it.
+        uint32_t intervalUs;
+        if (!ring.pop(intervalUs)) {
+            running = false;   // stream drained; next push() restarts immediately
+            return;
+        }
+
+        const uint32_t late = (uint32_t)(time_us_64() - deadlineUs);
+        if (late > lateMaxUs) lateMaxUs = late;
+
+        pulse();
+        emitted = emitted + 1;
+
+        deadlineUs += intervalUs;
+        // false = armed in the future; true = deadline already passed -> step now,
+        // but keep the minimum low time between back-to-back pulses.
+        if (!hardware_alarm_set_target((unsigned)alarm, from_us_since_boot(deadlineUs))) return;
+        busy_wait_us_32(kMinIntervalUs - 3);
+    }
+}
+
+#endif // ARDUINO_ARCH_RP2040
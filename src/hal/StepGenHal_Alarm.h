@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+#include "StepGenHal.h"
+#include "../platform/util/SpscRing.h"
+
+// RP2040 hardware-alarm step generator.
+// The timer alarm ISR pulses STEP, pops the next interval and re-arms itself at
+// an absolute deadline (previous deadline + interval), so neither loop() latency
+// nor ISR latency accumulates into the step schedule. Each instance (bed channel)
+// claims its own hardware alarm.
+class StepGenHal_Alarm : public StepGenHal {
+public:
+    explicit StepGenHal_Alarm(uint8_t stepPin);
+
+    bool begin() override;
+
+    uint16_t freeSlots() const override { return ring.freeSlots(); }
+    bool push(uint32_t intervalUs) override;
+    uint16_t queued() const override { return ring.size(); }
+
+    uint32_t takeEmitted() override;
+    uint32_t pendingEmitted() const override { return emitted - reported; }
+    void flush() override;
+
+    uint32_t maxLateUs() const override { return lateMaxUs; }
+    void resetTimingStats() override { lateMaxUs = 0; }
+
+    // Minimum spacing the ISR will honour when it has fallen behind.
+    static constexpr uint32_t kMinIntervalUs = 8;
+
+private:
+    static void alarmRouter(unsigned alarmNum);
+    void onAlarm();
+    void pulse();
+
+private:
+    uint8_t pin;
+    int8_t alarm = -1;
+
+    platform::util::SpscRing<uint32_t, 64> ring;
+    volatile bool running = false;
+    volatile uint32_t emitted = 0;
+    volatile uint32_t lateMaxUs = 0;
+    uint64_t deadlineUs = 0;     // ISR-owned while running
+    uint32_t reported = 0;
+
+    static StepGenHal_Alarm* instances[4];   // by hardware alarm number
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include <stdint.h>
+#include "StepGenHal.h"
+#include "../platform/util/SpscRing.h"
+
+// Host-side step generator (no Arduino dependency).
+// Time only moves when the test calls advanceUs(); every emitted pulse is logged
+// together with the interval that preceded it so the stream can be checked on Linux.
+class StepGenHal_Mock : public StepGenHal {
+public:
+    static constexpr uint16_t kLogMax = 512;
+
+    bool begin() override { reset(); return true; }
+
+    uint16_t freeSlots() const override { return ring.freeSlots(); }
+    bool push(uint32_t intervalUs) override { return ring.push(intervalUs); }
+    uint16_t queued() const override { return ring.size(); }
+
+    uint32_t takeEmitted() override {
+        const uint32_t n = emitted - reported;
+        reported = emitted;
+        return n;
+    }
+
+    uint32_t pendingEmitted() const override { return emitted - reported; }
+
+    void flush() override {
+        ring.clear();
+        busy = false;
+    }
+
+    // Simulate `us` microseconds of hardware time.
+    void advanceUs(uint32_t us) {
+        const uint32_t endUs = nowUs + us;
+        for (;;) {
+            if (!busy) {
+                uint32_t iv;
+                if (!ring.pop(iv)) break;
+                pulse(nowUs, iv);
+                continue;
+            }
+            if ((int32_t)(endUs - nextPulseUs) < 0) break;
+            uint32_t iv;
+            if (!ring.pop(iv)) { busy = false; nowUs = nextPulseUs; continue; }
+            pulse(nextPulseUs, iv);
+        }
+        nowUs = endUs;
+    }
+
+    void reset() {
+        ring.clear();
+        busy = false;
+        nowUs = 0;
+        nextPulseUs = 0;
+        lastPulseUs = 0;
+        emitted = 0;
+        reported = 0;
+        logCount = 0;
+    }
+
+    uint32_t nowMicros() const { return nowUs; }
+    uint32_t totalEmitted() const { return emitted; }
+
+    // Gap between pulse i-1 and pulse i (index 0 is the first pulse, gap 0).
+    uint16_t loggedCount() const { return logCount; }
+    uint32_t loggedGapUs(uint16_t i) const { return (i < logCount) ? gapLog[i] : 0; }
+
+private:
+    void pulse(uint32_t atUs, uint32_t intervalUs) {
+        if (logCount < kLogMax) gapLog[logCount++] = (emitted == 0) ? 0 : (atUs - lastPulseUs);
+        lastPulseUs = atUs;
+        emitted++;
+        busy = true;
+        nowUs = atUs;
+        nextPulseUs = atUs + intervalUs;
+    }
+
+    platform::util::SpscRing<uint32_t, 64> ring;
+    bool busy = false;
+    uint32_t nowUs = 0;
+    uint32_t nextPulseUs = 0;
+    uint32_t lastPulseUs = 0;
+    uint32_t emitted = 0;
+    uint32_t reported = 0;
+
+    uint32_t gapLog[kLogMax] = {0};
+    uint16_t logCount = 0;
+};
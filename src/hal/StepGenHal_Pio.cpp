@@ -0,0 +1,164 @@
+#include "StepGenHal_Pio.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <hardware/clocks.h>
+#include <hardware/irq.h>
+#include <hardware/sync.h>
+
+// .program step_pulse
+// .side_set 1
+// .wrap_target
+//     pull block      side 0      ; wait for the next interval word
+//     out x, 32       side 1 [2]  ; STEP high for 3 cycles (3us @ 1 MHz)
+// hold:
+//     jmp x-- hold    side 0      ; STEP low, idle x+1 cycles
+// .wrap
+static const uint16_t kStepPulseInstr[] = {
+    0x80A0, // 0: pull block       side 0
+    0x7220, // 1: out x, 32        side 1 [2]
+    0x0042, // 2: jmp x--, 2       side 0
+};
+
+static const struct pio_program kStepPulseProgram = {
+    .instructions = kStepPulseInstr,
+    .length = 3,
+    .origin = -1,
+};
+
+StepGenHal_Pio* StepGenHal_Pio::instances[kMaxInstances] = {};
+uint8_t StepGenHal_Pio::instanceCount = 0;
+bool StepGenHal_Pio::irqHooked[2] = {false, false};
+int8_t StepGenHal_Pio::programOffset[2] = {-1, -1};
+
+StepGenHal_Pio::StepGenHal_Pio(uint8_t stepPin) : pin(stepPin) {}
+
+bool StepGenHal_Pio::begin() {
+    if (instanceCount >= kMaxInstances) return false;
+    // first block with a free SM that has (or can take) the program
+    PIO p = nullptr;
+    uint8_t block = 0;
+    int claimed = -1;
+    for (; block < 2; block++) {
+        p = block ? pio1 : pio0;
+        if (programOffset[block] < 0 && !pio_can_add_program(p, &kStepPulseProgram)) continue;
+        claimed = pio_claim_unused_sm(p, false);
+        if (claimed >= 0) break;
+    }
+    if (claimed < 0) return false;
+    if (programOffset[block] < 0) programOffset[block] = (int8_t)pio_add_program(p, &kStepPulseProgram);
+
+    pio = p;
+    sm = (uint8_t)claimed;
+    offset = (uint8_t)programOffset[block];
+
+    pio_gpio_init(p, pin);
+    pio_sm_set_consecutive_pindirs(p, sm, pin, 1, true);
+
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset, offset + 2);
+    sm_config_set_sideset(&c, 1, false, false);
+    sm_config_set_sideset_pins(&c, pin);
+    sm_config_set_out_shift(&c, true, false, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    sm_config_set_clkdiv(&c, (float)clock_get_hz(clk_sys) / 1000000.0f);
+
+    pio_sm_init(p, sm, offset, &c);
+    pio_sm_set_pins_with_mask(p, sm, 0, 1u << pin);
+    pio_sm_set_enabled(p, sm, true);
+
+    instances[instanceCount++] = this;
+    irqNum = block ? PIO1_IRQ_0 : PIO0_IRQ_0;
+    if (!irqHooked[block]) {
+        irq_add_shared_handler(irqNum, irqRouter, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(irqNum, true);
+        irqHooked[block] = true;
+    }
+
+    ready = true;
+    return true;
+}
+
+void StepGenHal_Pio::setTxIrq(bool on) {
+    const enum pio_interrupt_source src =
+        (enum pio_interrupt_source)(pis_sm0_tx_fifo_not_full + sm);
+    pio_set_irq0_source_enabled(pio, src, on);
+    txArmed = on;
+}
+
+bool StepGenHal_Pio::push(uint32_t intervalUs) {
+    if (!ready) return false;
+    if (intervalUs < kMinIntervalUs) intervalUs = kMinIntervalUs;
+    if (!ring.push(intervalUs - kLoopOverheadCycles)) return false;
+    setTxIrq(true);   // (re)arm the FIFO feeder
+    return true;
+}
+
+uint16_t StepGenHal_Pio::queued() const {
+    if (!ready) return 0;
+    return (uint16_t)(ring.size() + pio_sm_get_tx_fifo_level(pio, sm));
+}
+
+uint32_t StepGenHal_Pio::emittedTotal() const {
+    // Pulse-first program: every word pulled out of the FIFO is a pulse on STEP.
+    return fed - pio_sm_get_tx_fifo_level(pio, sm);
+}
+
+uint32_t StepGenHal_Pio::takeEmitted() {
+    if (!ready) return 0;
+    const uint32_t irqState = save_and_disable_interrupts();
+    const uint32_t total = emittedTotal();
+    restore_interrupts(irqState);
+
+    const uint32_t n = total - reported;
+    reported = total;
+    return n;
+}
+
+uint32_t StepGenHal_Pio::pendingEmitted() const {
+    if (!ready) return 0;
+    const uint32_t irqState = save_and_disable_interrupts();
+    const uint32_t total = emittedTotal();
+    restore_interrupts(irqState);
+    return total - reported;
+}
+
+void StepGenHal_Pio::flush() {
+    if (!ready) return;
+    PIO p = pio;
+
+    const uint32_t irqState = save_and_disable_interrupts();
+    setTxIrq(false);
+    pio_sm_set_enabled(p, sm, false);
+    const uint32_t total = emittedTotal();
+
+    ring.clear();
+    pio_sm_clear_fifos(p, sm);
+    pio_sm_restart(p, sm);
+    pio_sm_exec(p, sm, pio_encode_jmp(offset));
+    pio_sm_set_pins_with_mask(p, sm, 0, 1u << pin);   // never leave STEP high
+    fed = total;
+
+    pio_sm_set_enabled(p, sm, true);
+    restore_interrupts(irqState);
+}
+
+void StepGenHal_Pio::irqRouter() {
+    // shared line: every SM whose feeder is armed gets a turn (idle ones return at once)
+    for (uint8_t i = 0; i < instanceCount; i++) instances[i]->onTxIrq();
+}
+
+void StepGenHal_Pio::onTxIrq() {
+    if (!txArmed) return;   // feeder idle for this SM
+    PIO p = pio;
+    while (!pio_sm_is_tx_fifo_full(p, sm)) {
+        uint32_t word;
+        if (!ring.pop(word)) {
+            setTxIrq(false);   // nothing left; push() re-arms
+            return;
+        }
+        pio_sm_put(p, sm, word);
+        fed = fed + 1;
+    }
+}
+
+#endif // ARDUINO_ARCH_RP2040
@@ -0,0 +1,57 @@
+#pragma once
+#include <Arduino.h>
+#include <hardware/pio.h>
+#include "StepGenHal.h"
+#include "../platform/util/SpscRing.h"
+
+// RP2040 PIO step generator.
+// A 3-instruction state machine pulls one delay word per step, drives STEP high
+// for 3us via side-set and then counts the delay down at 1 MHz. A software ring
+// refills the (joined, 8-deep) TX FIFO from the PIO "TX not full" interrupt, so
+// up to ~70 steps can be queued ahead of MotionController::tick().
+// Several instances (one per bed channel) share the program (loaded once per PIO block)
+// and the block's IRQ line; pio1 is used once pio0 has no free SM or program space.
+// All of them must begin() on the core that feeds them.
+class StepGenHal_Pio : public StepGenHal {
+public:
+    explicit StepGenHal_Pio(uint8_t stepPin);
+
+    bool begin() override;
+
+    uint16_t freeSlots() const override { return ring.freeSlots(); }
+    bool push(uint32_t intervalUs) override;
+    uint16_t queued() const override;
+
+    uint32_t takeEmitted() override;
+    uint32_t pendingEmitted() const override;
+    void flush() override;
+
+    // Fixed cost of one program loop (pull + pulse + final jmp), in PIO cycles.
+    static constexpr uint32_t kLoopOverheadCycles = 5;
+    static constexpr uint32_t kMinIntervalUs = kLoopOverheadCycles + 1;
+
+private:
+    static void irqRouter();
+    void onTxIrq();
+    uint32_t emittedTotal() const;   // call with interrupts disabled
+    void setTxIrq(bool on);
+
+private:
+    uint8_t pin;
+    PIO pio = nullptr;
+    uint8_t sm = 0;
+    uint8_t offset = 0;
+    uint8_t irqNum = 0;
+    bool ready = false;
+
+    platform::util::SpscRing<uint32_t, 64> ring;
+    volatile bool txArmed = false;   // TX-not-full IRQ source enabled
+    volatile uint32_t fed = 0;       // words moved into the TX FIFO (ISR)
+    uint32_t reported = 0;
+
+    static constexpr uint8_t kMaxInstances = 8;   // 2 PIO blocks x 4 state machines
+    static StepGenHal_Pio* instances[kMaxInstances];
+    static uint8_t instanceCount;
+    static bool irqHooked[2];
+    static int8_t programOffset[2];   // per PIO block, -1 = not loaded
+};
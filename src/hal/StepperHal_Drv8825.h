@@ -5,41 +5,45 @@
 
 class StepperHal_Drv8825 {
 public:
+    StepperHal_Drv8825() = default;
+    explicit StepperHal_Drv8825(const MotionPins& p) : pins(p) {}
+
     void begin() {
-        pinMode(PIN_STEP, OUTPUT);
-        pinMode(PIN_DIR, OUTPUT);
-        pinMode(PIN_ENABLE, OUTPUT);
-        if (PIN_MS1 != 255) pinMode(PIN_MS1, OUTPUT);
-        if (PIN_MS2 != 255) pinMode(PIN_MS2, OUTPUT);
-        if (PIN_MS3 != 255) pinMode(PIN_MS3, OUTPUT);
+        pinMode(pins.step, OUTPUT);
+        pinMode(pins.dir, OUTPUT);
+        pinMode(pins.enable, OUTPUT);
+        if (pins.ms1 != 255) pinMode(pins.ms1, OUTPUT);
+        if (pins.ms2 != 255) pinMode(pins.ms2, OUTPUT);
+        if (pins.ms3 != 255) pinMode(pins.ms3, OUTPUT);
         enable(true);
     }
 
     void enable(bool on) {
         // DRV8825: ENABLE LOW = enabled
-        digitalWrite(PIN_ENABLE, on ? LOW : HIGH);
+        digitalWrite(pins.enable, on ? LOW : HIGH);
         enabled = on;
     }
 
     bool isEnabled() const { return enabled; }
 
     void setDir(bool forward) {
-        digitalWrite(PIN_DIR, forward ? HIGH : LOW);
+        digitalWrite(pins.dir, forward ? HIGH : LOW);
     }
 
     void setMicrostepPins(bool ms1, bool ms2, bool ms3) {
-        if (PIN_MS1 != 255) digitalWrite(PIN_MS1, ms1 ? HIGH : LOW);
-        if (PIN_MS2 != 255) digitalWrite(PIN_MS2, ms2 ? HIGH : LOW);
-        if (PIN_MS3 != 255) digitalWrite(PIN_MS3, ms3 ? HIGH : LOW);
+        if (pins.ms1 != 255) digitalWrite(pins.ms1, ms1 ? HIGH : LOW);
+        if (pins.ms2 != 255) digitalWrite(pins.ms2, ms2 ? HIGH : LOW);
+        if (pins.ms3 != 255) digitalWrite(pins.ms3, ms3 ? HIGH : LOW);
     }
 
     inline void stepPulse() {
         // STEP minimum high pulse width: > 1.9us (DRV8825 datasheet). Use 3us.
-        digitalWrite(PIN_STEP, HIGH);
+        digitalWrite(pins.step, HIGH);
         delayMicroseconds(3);
-        digitalWrite(PIN_STEP, LOW);
+        digitalWrite(pins.step, LOW);
     }
 
 private:
+    MotionPins pins = kMotionPins[0];
     bool enabled = false;
 };
@@ -0,0 +1,90 @@
+#pragma once
+#include <Arduino.h>
+#include <hardware/gpio.h>
+#include <hardware/timer.h>
+#include <hardware/structs/sio.h>
+#include "../config/PinMap.h"
+
+// DRV8825 HAL writing the RP2040 SIO set/clear registers directly.
+//
+// Pins is a pin-set type: with static constexpr members (DefaultStepperPins) every mask
+// folds to an immediate; a struct with plain members works too (runtime pin tables).
+// EN/DIR/MS writes go through a shadow of the last driven level, so calling enable()/
+// setDir() every tick costs one compare and no bus write when nothing changed.
+//
+// Pin value 255 = not connected (mask 0).
+struct DefaultStepperPins {
+    static constexpr uint8_t step = PIN_STEP;
+    static constexpr uint8_t dir = PIN_DIR;
+    static constexpr uint8_t enable = PIN_ENABLE;
+    static constexpr uint8_t ms1 = PIN_MS1;
+    static constexpr uint8_t ms2 = PIN_MS2;
+    static constexpr uint8_t ms3 = PIN_MS3;
+};
+
+template <typename Pins = DefaultStepperPins>
+class StepperHal_Sio {
+public:
+    StepperHal_Sio() = default;
+    explicit StepperHal_Sio(const Pins& p) : pins(p) {}
+
+    void begin() {
+        const uint32_t outMask = mask(pins.step) | mask(pins.dir) | mask(pins.enable) |
+                                 mask(pins.ms1) | mask(pins.ms2) | mask(pins.ms3);
+        for (uint8_t g = 0; g < 30; g++) {
+            if (outMask & (1u << g)) gpio_init(g);   // SIO function, output low
+        }
+        sio_hw->gpio_clr = outMask;
+        sio_hw->gpio_oe_set = outMask;
+        shadow = 0;                 // every output was just driven low
+        shadowValid = outMask;
+        enable(true);
+    }
+
+    void enable(bool on) {
+        // DRV8825: ENABLE LOW = enabled
+        drive(mask(pins.enable), !on);
+        enabled = on;
+    }
+
+    bool isEnabled() const { return enabled; }
+
+    void setDir(bool forward) { drive(mask(pins.dir), forward); }
+
+    void setMicrostepPins(bool ms1, bool ms2, bool ms3) {
+        drive(mask(pins.ms1), ms1);
+        drive(mask(pins.ms2), ms2);
+        drive(mask(pins.ms3), ms3);
+    }
+
+    inline void stepPulse() {
+        // STEP minimum high pulse width: > 1.9us (DRV8825 datasheet). Use 3us.
+        const uint32_t m = mask(pins.step);
+        sio_hw->gpio_set = m;
+        busy_wait_us_32(3);
+        sio_hw->gpio_clr = m;
+    }
+
+    // Raw SIO writes actually issued (EN/DIR/MS), for comparing against call counts.
+    uint32_t pinWrites() const { return writes; }
+
+private:
+    static constexpr uint32_t mask(uint8_t gpio) { return gpio < 30 ? (1u << gpio) : 0u; }
+
+    inline void drive(uint32_t m, bool high) {
+        if (!m) return;
+        const uint32_t want = high ? m : 0u;
+        if ((shadowValid & m) && (shadow & m) == want) return;
+        if (high) sio_hw->gpio_set = m;
+        else      sio_hw->gpio_clr = m;
+        shadow = (shadow & ~m) | want;
+        shadowValid |= m;
+        writes++;
+    }
+
+    Pins pins{};
+    uint32_t shadow = 0;        // last driven level per pin
+    uint32_t shadowValid = 0;   // pins whose shadow is known
+    uint32_t writes = 0;
+    bool enabled = false;
+};
@@ -1,6 +1,8 @@
 
 #include <Arduino.h>
+#include <atomic>
 #include "config/Defaults.h"
+#include "config/Features.h"
 #include "app/controllers/MotionController.h"
 #include "app/controllers/EncoderController.h"
 #include "app/ui/UiController.h"
@@ -8,13 +10,50 @@
 #include "platform/envelope/EnvelopeCodec.h"
 
 #include "app/system/SettingsStore.h"
+#include "app/system/TaskScheduler.h"
+#include "app/system/LoopProfiler.h"
+#if LOOP_TICKLESS
+#include <pico/time.h>
+#endif
 #include "hal/EncoderHal_Arduino.h"
+#if MOTION_STEP_BACKEND == MOTION_STEP_BACKEND_PIO
+#include "hal/StepGenHal_Pio.h"
+#elif MOTION_STEP_BACKEND == MOTION_STEP_BACKEND_ALARM
+#include "hal/StepGenHal_Alarm.h"
+#endif
 
 MotionConfig motionCfg;
 UiConfig uiCfg;
 EncoderConfig encCfg;
 
-MotionController motion;
+// One controller per bed channel (pins from kMotionPins[]). The local UI, LED policy
+// and factory auto test drive channel 0; BedLink reaches every channel.
+MotionController motions[MOTION_CHANNELS];
+MotionController& motion = motions[0];
+
+#if MOTION_STEP_BACKEND == MOTION_STEP_BACKEND_PIO
+using StepGen = StepGenHal_Pio;
+#elif MOTION_STEP_BACKEND == MOTION_STEP_BACKEND_ALARM
+using StepGen = StepGenHal_Alarm;
+#endif
+#if MOTION_STEP_BACKEND != MOTION_STEP_BACKEND_POLLED
+static StepGen stepGen0(kMotionPins[0].step);
+#if MOTION_CHANNELS > 1
+static StepGen stepGen1(kMotionPins[1].step);
+#endif
+#if MOTION_CHANNELS > 2
+static StepGen stepGen2(kMotionPins[2].step);
+#endif
+static StepGen* const stepGens[MOTION_CHANNELS] = {
+    &stepGen0,
+#if MOTION_CHANNELS > 1
+    &stepGen1,
+#endif
+#if MOTION_CHANNELS > 2
+    &stepGen2,
+#endif
+};
+#endif
 
 EncoderHal_Arduino encHal;
 EncoderController enc(encHal);
@@ -23,21 +62,85 @@ UiController ui;
 
 static SettingsStore store;
 static PersistedData persist;
+#if MOTION_CHANNELS > 1
+static PersistedChannel persistCh[MOTION_CHANNELS];   // [0] unused: channel 0 lives in persist
+#endif
 
-// ---- delayed persistence for config (debounced flash writes) ----
-static bool gCfgDirty = false;
-static uint32_t gCfgDirtySinceMs = 0;
+// core0 work (motion/input/UI/persistence/logs), see setupTasks()
+static TaskScheduler sched;
+static int8_t gTaskConfigSave = -1;
+static void setupTasks();
 
-// Called from UI when user commits parameter edits.
+// ---- delayed persistence for config (debounced flash writes) ----
+// Called from UI (and BedLink config commands) when settings change: saves 1 s after the last edit.
 void markPersistDirty() {
-    gCfgDirty = true;
-    gCfgDirtySinceMs = millis();
+    sched.arm(gTaskConfigSave, 1000);
 }
 
 product::growbed::GrowBedNode node;
 
+// Learned travel + park position for the next warm start. Written only at rest (pos exact,
+// fine microstep) and cleared once motion resumes, so a power cut mid-stroke never restores a
+// stale park position. A park is committed only after the bed has stayed Stopped for
+// kParkCommitMs: a short pause/resume never touches flash, and only a committed park costs
+// the clearing save at resume. Returns true when the persisted fields changed.
+static constexpr uint32_t kParkCommitMs = 10000;
+static uint32_t gParkSinceMs[MOTION_CHANNELS];   // Stopped since (0 = moving)
+
+static bool updateMotionGeometry(const MotionStatus& stM, uint32_t nowMs, uint32_t& parkSinceMs,
+                                 uint32_t& travelSteps, int32_t& parkPos,
+                                 uint8_t& parkValid, uint8_t& microstepDiv) {
+    const bool atRest = (stM.state == MotionState::Dwell || stM.state == MotionState::Stopped);
+    const bool stopped = (stM.state == MotionState::Stopped && stM.posValid);
+    if (!stopped) parkSinceMs = 0;
+    else if (parkSinceMs == 0) parkSinceMs = nowMs | 1u;
+    // still settling: keep whatever is stored (a park restored at boot stays valid)
+    if (stopped && nowMs - parkSinceMs < kParkCommitMs) return false;
+    const uint8_t park = stopped ? 1 : 0;
+    const bool travelChanged = atRest && stM.travelSteps > 0 && stM.travelSteps != travelSteps;
+    // travel 0: nothing learned yet (or the core1 view before its first publish)
+    if (stM.travelSteps == 0 ||
+        !(travelChanged || park != parkValid || (park && (int32_t)stM.pos != parkPos))) {
+        return false;
+    }
+    if (atRest) {
+        travelSteps = stM.travelSteps;
+        microstepDiv = stM.microstepDiv;
+    }
+    parkValid = park;
+    parkPos = park ? (int32_t)stM.pos : 0;
+    return true;
+}
+
+// EVT envelope -> LineBed transport (placeholder: Serial hex dump, prefixed with `tag`).
+static void sendEvent(const char* tag, const platform::envelope::Envelope& env) {
+    uint8_t payload[48];
+    const uint16_t n = platform::envelope::BedLinkBinaryCodec::encode(env, payload, sizeof(payload));
+    if (n == 0) return;
+
+    Serial.print(tag);
+    for (uint16_t i = 0; i < n; i++) {
+        if (payload[i] < 16) Serial.print('0');
+        Serial.print(payload[i], HEX);
+        Serial.print(' ');
+    }
+    Serial.println();
+
+    // TODO: replace with RS485/BedLink transport to LineBed
+    // e.g., Serial1.write(payload, n);
+}
+
+#if MOTION_ON_CORE1
+// core0 setup() hands the persisted config to core1 once everything else is configured.
+static MotionConfig gMotionBootCfg[MOTION_CHANNELS];
+static std::atomic<bool> gMotionStart{false};
+#endif
+
 void setup() {
     Serial.begin(115200);
+#if LOOP_PROFILER
+    LoopProfiler::beginCore();
+#endif
 
     store.begin();
 
@@ -52,14 +155,45 @@ void setup() {
     persist.resetCount++;
     store.save(persist);
 
-    // ✅ begin에 persist.cfg를 바로 넣는다 (핵심)
-    motion.begin(persist.cfg);
-        
-
-    // apply persisted LED policy
-    if (persist.ledMode == 0) motion.setLedModeAuto();
-    else motion.setLedModeManual(persist.ledManualOn != 0);
-    motion.setLedScheduleMinutes(persist.ledOnStartMin, persist.ledOnEndMin);
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) {
+        MotionController& m = motions[ch];
+        m.setChannel(ch, kMotionPins[ch]);
+#if MOTION_STEP_BACKEND != MOTION_STEP_BACKEND_POLLED
+        m.attachStepGenerator(stepGens[ch]);
+#endif
+
+        MotionConfig cfg = persist.cfg;
+        // learned travel / park position: begin() warm-starts from it instead of calibrating
+        if (ch == 0) {
+            m.applyPersistedMotion(persist.motionTravelSteps, persist.motionParkPos,
+                                   persist.motionParkValid != 0, persist.motionMicrostepDiv);
+        }
+#if MOTION_CHANNELS > 1
+        else {
+            PersistedChannel& pc = persistCh[ch];
+            if (!store.loadChannel(ch, pc)) {
+                pc = PersistedChannel{};
+                pc.channel = ch;
+                pc.cfg = m.config();
+            }
+            cfg = pc.cfg;
+            m.applyPersistedMotion(pc.motionTravelSteps, pc.motionParkPos,
+                                   pc.motionParkValid != 0, pc.motionMicrostepDiv);
+        }
+#endif
+
+        // ✅ begin에 persist.cfg를 바로 넣는다 (핵심)
+#if MOTION_ON_CORE1
+        gMotionBootCfg[ch] = cfg;   // begin() runs on core1 (setup1) so step/hall IRQs live there
+#else
+        m.begin(cfg);
+#endif
+
+        // apply persisted LED policy (one grow schedule for every bed)
+        if (persist.ledMode == 0) m.setLedModeAuto();
+        else m.setLedModeManual(persist.ledManualOn != 0);
+        m.setLedScheduleMinutes(persist.ledOnStartMin, persist.ledOnEndMin);
+    }
 
     // restore recent alerts
     motion.applyPersistedAlerts(persist.alertSeq, persist.alertHead, persist.alertCount,
@@ -83,72 +217,125 @@ void setup() {
                                 persist.factoryLogUptimeSec,
                                 persist.factoryLogCycles);
 
-    node.begin(&motion);
+#if MOTION_ON_CORE1
+    // restored alerts/factory/travel are visible to core0 readers (UI, taskPersist) while
+    // core1 is still in begin()
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) motions[ch].publishBootStatus(gMotionBootCfg[ch]);
+#endif
+
+    MotionController* motionList[MOTION_CHANNELS];
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) motionList[ch] = &motions[ch];
+    node.begin(motionList, MOTION_CHANNELS);
 
     // Alert EVT -> LineBed transport (placeholder: Serial hex dump)
-    motion.setAlertCallback([](uint8_t code, uint32_t /*seq*/, uint32_t uptimeMs, uint32_t cycles) {
+    const MotionController::AlertCallback onAlert =
+        [](uint8_t channel, uint8_t code, uint32_t /*seq*/, uint32_t uptimeMs, uint32_t cycles) {
         uint8_t data[16];
         platform::envelope::Envelope env;
-        if (!node.buildEventAlert(env, data, sizeof(data), code, uptimeMs, cycles)) return;
-        uint8_t payload[32];
-        uint16_t n = platform::envelope::BedLinkBinaryCodec::encode(env, payload, sizeof(payload));
-        if (n == 0) return;
-
-        Serial.print("[EVT ALERT] ");
-        for (uint16_t i = 0; i < n; i++) {
-            if (payload[i] < 16) Serial.print('0');
-            Serial.print(payload[i], HEX);
-            Serial.print(' ');
-        }
-        Serial.println();
-
-        // TODO: replace with RS485/BedLink transport to LineBed
-        // e.g., Serial1.write(payload, n);
-    });
+        if (!node.buildEventAlert(env, data, sizeof(data), code, uptimeMs, cycles, channel)) return;
+        sendEvent("[EVT ALERT] ", env);
+    };
 
     // Factory validation EVT -> LineBed transport (placeholder: Serial hex dump)
-    motion.setFactoryCallback([](uint32_t seq, bool pass, uint8_t failCode, uint8_t failStep, uint32_t durationMs, uint32_t uptimeMs, uint32_t cycles) {
+    const MotionController::FactoryCallback onFactory =
+        [](uint8_t channel, uint32_t seq, bool pass, uint8_t failCode, uint8_t failStep, uint32_t durationMs, uint32_t uptimeMs, uint32_t cycles) {
         uint8_t data[32];
         platform::envelope::Envelope env;
-        if (!node.buildEventFactoryValidation(env, data, sizeof(data), seq, pass, failCode, failStep, durationMs, uptimeMs, cycles)) return;
-        uint8_t payload[48];
-        uint16_t n = platform::envelope::BedLinkBinaryCodec::encode(env, payload, sizeof(payload));
-        if (n == 0) return;
-
-        Serial.print("[EVT FACTORY] ");
-        for (uint16_t i = 0; i < n; i++) {
-            if (payload[i] < 16) Serial.print('0');
-            Serial.print(payload[i], HEX);
-            Serial.print(' ');
+        if (!node.buildEventFactoryValidation(env, data, sizeof(data), seq, pass, failCode, failStep, durationMs, uptimeMs, cycles, channel)) return;
+        sendEvent("[EVT FACTORY] ", env);
+    };
+
+    // Auto tune finished: commit the winning maxSps/accel, then report it (Serial hex dump)
+    const MotionController::AutoTuneCallback onAutoTune =
+        [](uint8_t channel, uint32_t seq, AutoTuneResult result, uint8_t stagesPassed, uint32_t maxSps, uint32_t accel) {
+        if (result != AutoTuneResult::Aborted) {
+            MotionConfig* cfg = &persist.cfg;
+#if MOTION_CHANNELS > 1
+            if (channel > 0) cfg = &persistCh[channel].cfg;
+#endif
+            // config() may not show the result yet (MOTION_ON_CORE1): take the reported values
+            *cfg = motions[channel].config();
+            cfg->maxSps = (float)maxSps;
+            cfg->accel = (float)accel;
+            if (channel == 0) store.save(persist);
+#if MOTION_CHANNELS > 1
+            else store.saveChannel(persistCh[channel]);
+#endif
         }
-        Serial.println();
 
-        // TODO: replace with RS485/BedLink transport to LineBed
-    });
+        uint8_t data[16];
+        platform::envelope::Envelope env;
+        if (!node.buildEventAutoTune(env, data, sizeof(data), seq, (uint8_t)result, stagesPassed, maxSps, accel, channel)) return;
+        sendEvent("[EVT AUTOTUNE] ", env);
+    };
+
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) {
+        motions[ch].setAlertCallback(onAlert);
+        motions[ch].setFactoryCallback(onFactory);
+        motions[ch].setAutoTuneCallback(onAutoTune);
+        motions[ch].setMotionStallPulseTimeoutMs(2000);
+        motions[ch].setMotionStallNoEndTimeoutMs(0);
+    }
 
     //-------------------------------------------
     // Auto Test
     //-------------------------------------------
-    motion.setMotionStallPulseTimeoutMs(2000);
-    motion.setMotionStallNoEndTimeoutMs(0);
 
     motion.startFactoryAutoTest(2000);   // 2초 간격, 10 cycles 기본
     
     encHal.beginPins();
     enc.begin(encCfg);
 
-    ui.begin(uiCfg, &motion);
+    ui.begin(uiCfg, motionList, MOTION_CHANNELS);
+
+    setupTasks();
+
+#if MOTION_ON_CORE1
+    gMotionStart.store(true, std::memory_order_release);
+#endif
 }
 
-void loop() {
+#if MOTION_ON_CORE1
+// ---- core1: motion only ----
+void setup1() {
+    while (!gMotionStart.load(std::memory_order_acquire)) { tight_loop_contents(); }
+#if LOOP_PROFILER
+    LoopProfiler::beginCore();   // SysTick is per core
+#endif
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) motions[ch].begin(gMotionBootCfg[ch]);
+}
+
+void loop1() {
+    PROF_SCOPE(ProfPhase::MotionTick);
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) motions[ch].tick();
+}
+#endif
+
+// ---- core0 tasks (see TaskScheduler) ----
+
+// status view + alert/factory callbacks (runs them on core0 in both modes), then motion
+static void taskMotion(uint32_t /*nowMs*/) {
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) motions[ch].pollEvents();
+#if !MOTION_ON_CORE1
+    PROF_SCOPE(ProfPhase::MotionTick);
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) motions[ch].tick();
+#endif
+}
+
+static void taskInput(uint32_t /*nowMs*/) {
+    PROF_BEGIN(poll, ProfPhase::EncPoll);
     EncoderEvents e = enc.poll();
+    PROF_END(poll);
     ui.handleEncoder(e);
+}
 
-    motion.tick();
-
-    ui.tick();
+static void taskUi(uint32_t /*nowMs*/) {
+    ui.tick();   // sensor / draw periods are kept inside UiController
+}
 
-    // Persist factory result whenever it changes (rare; OK to write immediately)
+// Factory result, alert log, warm-start geometry and fault counters: saved as soon as they
+// change (rare; OK to write immediately).
+static void taskPersist(uint32_t nowMs) {
     {
         const auto& stF = motion.status();
         if (stF.factorySeq != persist.factorySeq) {
@@ -164,7 +351,6 @@ void loop() {
         }
     }
 
-    // Persist alert log whenever a new alert arrives (faults are rare; OK to write immediately)
     {
         const auto& stA = motion.status();
         if (stA.alertSeq != persist.alertSeq) {
@@ -179,37 +365,76 @@ void loop() {
         }
     }
 
-    static uint32_t lastLogMs = 0;
-    uint32_t now = millis();
+    // Persist learned travel + park position for the next warm start (per channel).
+    if (updateMotionGeometry(motion.status(), nowMs, gParkSinceMs[0], persist.motionTravelSteps,
+                             persist.motionParkPos, persist.motionParkValid,
+                             persist.motionMicrostepDiv)) {
+        store.save(persist);
+    }
+#if MOTION_CHANNELS > 1
+    for (uint8_t ch = 1; ch < MOTION_CHANNELS; ch++) {
+        PersistedChannel& pc = persistCh[ch];
+        if (updateMotionGeometry(motions[ch].status(), nowMs, gParkSinceMs[ch], pc.motionTravelSteps,
+                                 pc.motionParkPos, pc.motionParkValid, pc.motionMicrostepDiv)) {
+            store.saveChannel(pc);
+        }
+    }
+#endif
 
-    // ---- debounced persistence for config/LED (flash/EEPROM wear reduction) ----
-    if (gCfgDirty && (now - gCfgDirtySinceMs) >= 1000) {
-        gCfgDirty = false;
+    static uint8_t lastPerm = 0;
+    const auto& st = motion.status();
+    persist.faultTotal = st.faultTotal;
+    persist.lastFaultCode = (uint8_t)st.lastErr;
+    persist.lastFaultUptimeMs = st.lastFaultUptimeMs;
 
-        // motion config
-        persist.cfg = motion.config();
+    if (st.permanentFault && !lastPerm) {
+        store.save(persist);
+    }
+    lastPerm = st.permanentFault ? 1 : 0;
+}
 
-        // LED policy snapshot from runtime status
-        const auto& st2 = motion.status();
-        persist.ledMode = (uint8_t)st2.ledMode;
-        persist.ledManualOn = st2.ledManualOn ? 1 : 0;
-        persist.ledOnStartMin = st2.ledOnStartMin;
-        persist.ledOnEndMin = st2.ledOnEndMin;
+// ---- debounced persistence for config/LED (flash/EEPROM wear reduction) ----
+static void taskConfigSave(uint32_t /*nowMs*/) {
+    // motion config
+    persist.cfg = motion.config();
+
+    // LED policy snapshot from runtime status
+    const auto& st2 = motion.status();
+    persist.ledMode = (uint8_t)st2.ledMode;
+    persist.ledManualOn = st2.ledManualOn ? 1 : 0;
+    persist.ledOnStartMin = st2.ledOnStartMin;
+    persist.ledOnEndMin = st2.ledOnEndMin;
+
+    // alert log snapshot
+    persist.alertSeq = st2.alertSeq;
+    persist.alertHead = st2.alertHead;
+    persist.alertCount = st2.alertCount;
+    for (uint8_t i = 0; i < 5; i++) {
+        persist.alertCodes[i] = st2.alertCodes[i];
+        persist.alertUptimeSec[i] = st2.alertUptimeSec[i];
+    }
 
-        // alert log snapshot
-        persist.alertSeq = st2.alertSeq;
-        persist.alertHead = st2.alertHead;
-        persist.alertCount = st2.alertCount;
-        for (uint8_t i = 0; i < 5; i++) {
-            persist.alertCodes[i] = st2.alertCodes[i];
-            persist.alertUptimeSec[i] = st2.alertUptimeSec[i];
-        }
+    store.save(persist);
 
-        store.save(persist);
+#if MOTION_CHANNELS > 1
+    // extra channels are only edited over BedLink; rewrite a slot only when its config moved
+    for (uint8_t ch = 1; ch < MOTION_CHANNELS; ch++) {
+        PersistedChannel& pc = persistCh[ch];
+        const MotionConfig c = motions[ch].config();
+        if (memcmp(&pc.cfg, &c, sizeof(c)) == 0) continue;
+        pc.cfg = c;
+        store.saveChannel(pc);
     }
-    if (now - lastLogMs >= 1000) {
-        lastLogMs = now;
-        const auto& st = motion.status();
+#endif
+}
+
+static void taskLog(uint32_t /*nowMs*/) {
+    PROF_SCOPE(ProfPhase::SerialLog);
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) {
+        const auto& st = motions[ch].status();
+#if MOTION_CHANNELS > 1
+        Serial.print("ch="); Serial.print(ch); Serial.print(' ');
+#endif
         Serial.print("state="); Serial.print((int)st.state);
         Serial.print(" sps="); Serial.print((int)st.currentSps);
         Serial.print(" pos="); Serial.print(st.pos);
@@ -219,17 +444,90 @@ void loop() {
         Serial.print(" Ract="); Serial.print(st.hallR ? 1 : 0);
         Serial.print(" err="); Serial.print((int)st.err);
         Serial.print(" travel="); Serial.print(st.travelSteps);
+        Serial.print(" late="); Serial.print(st.stepLateMaxUs);
+        Serial.print(" ovr="); Serial.print(st.stepOverruns);
+        Serial.print(" drop="); Serial.print(st.stepDropped);
+        Serial.print(" us=1/"); Serial.print(st.microstepDiv);
+        Serial.print(" drift="); Serial.print(st.driftLast);
         Serial.print(" cyc="); Serial.println(st.cycles);
     }
+}
+
+// name:runs/overruns/misses/execMax(us)/lateMax(ms) per task
+static void taskSchedLog(uint32_t /*nowMs*/) {
+    Serial.print("[SCHED]");
+    for (uint8_t i = 0; i < sched.count(); i++) {
+        const TaskScheduler::Task& t = sched.task(i);
+        Serial.print(' '); Serial.print(t.name);
+        Serial.print(':'); Serial.print(t.runs);
+        Serial.print('/'); Serial.print(t.overruns);
+        Serial.print('/'); Serial.print(t.misses);
+        Serial.print('/'); Serial.print(t.execMaxUs);
+        Serial.print('/'); Serial.print(t.lateMaxMs);
+    }
+    Serial.println();
+}
 
-    static uint8_t lastPerm = 0;
-    const auto& st = motion.status();
-    persist.faultTotal = st.faultTotal;
-    persist.lastFaultCode = (uint8_t)st.lastErr;
-    persist.lastFaultUptimeMs = st.lastFaultUptimeMs;
+#if LOOP_PROFILER
+// per phase: samples, min/avg/max (us), then the log2 histogram bins (see LoopProfiler)
+static void taskProfLog(uint32_t /*nowMs*/) {
+    for (uint8_t i = 0; i < LoopProfiler::kPhases; i++) {
+        const ProfPhase ph = (ProfPhase)i;
+        const LoopProfiler::PhaseStats& s = LoopProfiler::stats(ph);
+        Serial.print("[PROF] "); Serial.print(LoopProfiler::name(ph));
+        Serial.print(" n="); Serial.print(s.count);
+        Serial.print(" min="); Serial.print(LoopProfiler::toUs(s.minCyc));
+        Serial.print(" avg="); Serial.print(LoopProfiler::toUs(LoopProfiler::avgCyc(s)));
+        Serial.print(" max="); Serial.print(LoopProfiler::toUs(s.maxCyc));
+        Serial.print("us h=");
+        for (uint8_t b = 0; b < LoopProfiler::kBins; b++) {
+            if (b) Serial.print(',');
+            Serial.print(s.hist[b]);
+        }
+        Serial.println();
+    }
+}
+#endif
+
+static void setupTasks() {
+    // priority: motion > input > UI > persistence > logs. Budgets flag runs that would
+    // have held motion back for longer than expected (UI: full-frame I2C sendBuffer).
+    sched.addPeriodic("motion", taskMotion, TaskScheduler::kEveryPass, 7, 500);
+    sched.addPeriodic("input", taskInput, TaskScheduler::kEveryPass, 6, 200);
+    sched.addPeriodic("ui", taskUi, 10, 4, 30000);
+    sched.addPeriodic("persist", taskPersist, 20, 3, 50000);
+    gTaskConfigSave = sched.addOneShot("cfgsave", taskConfigSave, 3, 50000);
+    sched.addPeriodic("log", taskLog, 1000, 1, 5000);
+    sched.addPeriodic("sched", taskSchedLog, 10000, 0, 5000);
+#if LOOP_PROFILER
+    sched.addPeriodic("prof", taskProfLog, 30000, 0, 10000);
+#endif
+}
 
-    if (st.permanentFault && !lastPerm) {
-        store.save(persist);
+#if LOOP_TICKLESS
+// Sleep until the earliest next-wake hint. Core1 (MOTION_ON_CORE1) keeps spinning: the
+// timeout alarm fires on core0's alarm pool, so a timed WFE there is not guaranteed to end.
+static void idleUntilNextWake() {
+    uint32_t wait = sched.msUntilNextDue();
+#if !MOTION_ON_CORE1
+    for (uint8_t ch = 0; ch < MOTION_CHANNELS; ch++) {
+        const uint32_t m = motions[ch].msUntilNextTick();
+        if (m < wait) wait = m;
     }
-    lastPerm = st.permanentFault ? 1 : 0;
+#endif
+    const uint32_t e = enc.msUntilNextPoll();
+    if (e < wait) wait = e;
+    const uint32_t u = ui.msUntilNextTick();
+    if (u < wait) wait = u;
+
+    // 1 ms or less is not worth the alarm setup
+    if (wait >= 2) best_effort_wfe_or_timeout(make_timeout_time_ms(wait));
+}
+#endif
+
+void loop() {
+    sched.runPass();
+#if LOOP_TICKLESS
+    idleUntilNextWake();
+#endif
 }
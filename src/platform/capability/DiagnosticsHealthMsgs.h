@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+
+namespace platform::capability {
+
+// diagnostics.health (CAP 0x02); multi-byte fields little-endian
+static constexpr uint8_t DH_ALERT              = 0x10; // EVT
+static constexpr uint8_t DH_FACTORY_VALIDATION = 0x11; // EVT
+static constexpr uint8_t DH_AUTO_TUNE          = 0x12; // EVT
+static constexpr uint8_t DH_LOOP_PROFILE       = 0x13; // CMD uint8 phase (0xFF: reset all).
+                                                       // ACK: status, phase, uint32 n, min, avg,
+                                                       // max (us), uint16 x 20 histogram bins
+static constexpr uint8_t DH_STEP_JITTER        = 0x14; // CMD optional uint8 1: reset step timing
+                                                       // stats after the read. ACK: status,
+                                                       // uint32 samples, lost us, recovered us,
+                                                       // int32 worst us, uint32 worst commanded
+                                                       // us, uint8 worst state, uint32 worst
+                                                       // uptime ms, uint16 x 12 bins
+
+} // namespace platform::capability
@@ -10,4 +10,21 @@ static constexpr uint8_t ML_HOME       = 0x03;
 static constexpr uint8_t ML_SET_SPEED  = 0x04; // int16 sps
 static constexpr uint8_t ML_SET_DWELL  = 0x05; // uint16 ms
 
+// motion program (queued absolute moves; multi-byte fields little-endian)
+static constexpr uint8_t ML_PROG_CLEAR     = 0x06;
+static constexpr uint8_t ML_PROG_MOVE_TO   = 0x07; // int32 pos (fine steps), uint16 sps (0 = speed map)
+static constexpr uint8_t ML_PROG_MOVE_FRAC = 0x08; // uint16 permille of travel, uint16 sps
+static constexpr uint8_t ML_PROG_HOLD      = 0x09; // uint32 ms
+static constexpr uint8_t ML_PROG_SWEEP     = 0x0A; // uint8 unit (0 steps, 1 permille), int32 a, int32 b,
+                                                   // uint8 round trips, uint16 sps
+static constexpr uint8_t ML_PROG_RUN       = 0x0B;
+
+// auto tune (maxSps/accel stall-margin search); result arrives as a diagnostics.health EVT
+static constexpr uint8_t ML_AUTO_TUNE      = 0x0C; // uint8 1 start / 0 stop; optional: uint8 step %,
+                                                   // uint8 margin %, uint16 sps ceiling
+
+// speed map slot (MotionConfig::zones), persisted with the channel config
+static constexpr uint8_t ML_SET_ZONE       = 0x0D; // uint8 slot, uint16 from permille, uint16 to permille,
+                                                   // uint16 sps (from >= to clears the slot)
+
 } // namespace platform::capability
@@ -19,6 +19,8 @@ struct Envelope {
     uint8_t flags {0};
     bool hasSeq {false};
     uint16_t seq {0};
+    bool hasChannel {false};  // absent = channel 0
+    uint8_t channel {0};
 
     // V1: raw bytes to avoid tight coupling.
     const uint8_t* data {nullptr};
@@ -28,5 +30,6 @@ struct Envelope {
 // FLAGS bits (V1.1)
 static constexpr uint8_t FLAG_REQ_ACK = 0x01;
 static constexpr uint8_t FLAG_HAS_SEQ = 0x02;
+static constexpr uint8_t FLAG_HAS_CHANNEL = 0x04;  // one channel byte follows SEQ
 
 } // namespace platform::envelope
@@ -20,6 +20,14 @@ bool BedLinkBinaryCodec::decode(const uint8_t* p, uint16_t len, Envelope& out) {
         out.seq = 0;
     }
 
+    out.hasChannel = (out.flags & FLAG_HAS_CHANNEL) != 0;
+    if (out.hasChannel) {
+        if (len < idx + 1) return false;
+        out.channel = p[idx++];
+    } else {
+        out.channel = 0;
+    }
+
     out.data = (idx <= len) ? (p + idx) : nullptr;
     out.dataLen = (idx <= len) ? (len - idx) : 0;
     return true;
@@ -34,6 +42,7 @@ uint16_t BedLinkBinaryCodec::encode(const Envelope& env, uint8_t* out, uint16_t
 
     uint8_t flags = env.flags;
     if (env.hasSeq) flags |= FLAG_HAS_SEQ;
+    if (env.hasChannel) flags |= FLAG_HAS_CHANNEL;
     out[idx++] = flags;
 
     if (env.hasSeq) {
@@ -42,6 +51,11 @@ uint16_t BedLinkBinaryCodec::encode(const Envelope& env, uint8_t* out, uint16_t
         out[idx++] = (uint8_t)((env.seq >> 8) & 0xFF);
     }
 
+    if (env.hasChannel) {
+        if (outMax < idx + 1) return 0;
+        out[idx++] = env.channel;
+    }
+
     if (env.dataLen > 0) {
         if (!env.data) return 0;
         if (outMax < idx + env.dataLen) return 0;
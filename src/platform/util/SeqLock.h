@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+namespace platform::util {
+
+// Sequence-lock publication of a trivially copyable value.
+// One writer (any context); readers never block the writer and retry on a torn copy.
+// seq is odd while a write is in progress; a read is valid only if seq was even and
+// unchanged across the copy.
+//
+// Do not read from an ISR that can preempt the writer on the same core (it would spin
+// forever); use tryRead() there.
+template <typename T>
+class SeqLock {
+public:
+    // ---- writer side ----
+    void write(const T& v) {
+        const uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);   // odd seq before data
+        memcpy(&data, &v, sizeof(T));
+        seq.store(s + 2, std::memory_order_release);           // data before even seq
+    }
+
+    // ---- reader side ----
+    bool tryRead(T& out) const {
+        const uint32_t s0 = seq.load(std::memory_order_acquire);
+        if (s0 & 1u) return false;
+        memcpy(&out, &data, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);   // data before re-check
+        return seq.load(std::memory_order_relaxed) == s0;
+    }
+
+    void read(T& out) const {
+        while (!tryRead(out)) { }
+    }
+
+    // Even values count completed writes (version / 2).
+    uint32_t version() const { return seq.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> seq{0};
+    T data{};
+};
+
+} // namespace platform::util
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+namespace platform::util {
+
+// Lock-free single-producer / single-consumer ring buffer.
+// Producer and consumer may run in different contexts (loop vs ISR, core0 vs core1),
+// but push() must only be called from one side and pop()/clear() from the other.
+template <typename T, uint16_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    static constexpr uint16_t capacity() { return N; }
+
+    // ---- producer side ----
+    bool push(const T& v) {
+        const uint16_t h = head.load(std::memory_order_relaxed);
+        const uint16_t t = tail.load(std::memory_order_acquire);
+        if ((uint16_t)(h - t) >= N) return false;
+        buf[h & (N - 1)] = v;
+        head.store((uint16_t)(h + 1), std::memory_order_release);
+        return true;
+    }
+
+    // ---- consumer side ----
+    bool pop(T& out) {
+        const uint16_t t = tail.load(std::memory_order_relaxed);
+        const uint16_t h = head.load(std::memory_order_acquire);
+        if (h == t) return false;
+        out = buf[t & (N - 1)];
+        tail.store((uint16_t)(t + 1), std::memory_order_release);
+        return true;
+    }
+
+    // Drop everything currently queued (consumer side, or with the consumer stopped).
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // ---- either side (approximate while the other side is running) ----
+    uint16_t size() const {
+        return (uint16_t)(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+    }
+    uint16_t freeSlots() const { return (uint16_t)(N - size()); }
+    bool empty() const { return size() == 0; }
+
+private:
+    T buf[N] {};
+    std::atomic<uint16_t> head {0};
+    std::atomic<uint16_t> tail {0};
+};
+
+} // namespace platform::util
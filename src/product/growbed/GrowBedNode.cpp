@@ -1,17 +1,76 @@
 #include "GrowBedNode.h"
 #include "../../platform/capability/CapIds.h"
 #include "../../platform/capability/MotionLinearMsgs.h"
+#include "../../platform/capability/DiagnosticsHealthMsgs.h"
 #include "../../app/controllers/MotionController.h"
+#include "../../app/system/LoopProfiler.h"
+
+extern void markPersistDirty();
 
 namespace product::growbed {
 
-void GrowBedNode::begin(MotionController* motion) { _motion = motion; }
+static uint16_t rdU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rdU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void wrU32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)((v >> 8) & 0xFF);
+    p[2] = (uint8_t)((v >> 16) & 0xFF);
+    p[3] = (uint8_t)((v >> 24) & 0xFF);
+}
+
+// DH_STEP_JITTER reply after the status byte (see DiagnosticsHealthMsgs.h)
+static constexpr uint16_t kStepJitterLen = 4 * 5 + 1 + 4 + 2 * MotionStatus::kStepJitterBins;
+
+static uint16_t writeStepJitter(uint8_t* out, const MotionStatus& st) {
+    wrU32(out + 0, st.stepJitterSamples);
+    wrU32(out + 4, st.stepLostUs);
+    wrU32(out + 8, st.stepRecoveredUs);
+    wrU32(out + 12, (uint32_t)st.stepJitterWorstUs);
+    wrU32(out + 16, st.stepJitterWorstCmdUs);
+    out[20] = (uint8_t)st.stepJitterWorstState;
+    wrU32(out + 21, st.stepJitterWorstMs);
+    for (uint8_t b = 0; b < MotionStatus::kStepJitterBins; b++) {
+        out[25 + 2 * b] = (uint8_t)(st.stepJitterHist[b] & 0xFF);
+        out[26 + 2 * b] = (uint8_t)(st.stepJitterHist[b] >> 8);
+    }
+    return kStepJitterLen;
+}
+
+#if LOOP_PROFILER
+
+// DH_LOOP_PROFILE reply after the status byte: phase, n, min/avg/max us, histogram bins
+static constexpr uint16_t kLoopProfileLen = 1 + 4 * 4 + 2 * LoopProfiler::kBins;
+
+static uint16_t writeLoopProfile(uint8_t* out, ProfPhase phase) {
+    const LoopProfiler::PhaseStats& s = LoopProfiler::stats(phase);
+    out[0] = (uint8_t)phase;
+    wrU32(out + 1, s.count);
+    wrU32(out + 5, LoopProfiler::toUs(s.minCyc));
+    wrU32(out + 9, LoopProfiler::toUs(LoopProfiler::avgCyc(s)));
+    wrU32(out + 13, LoopProfiler::toUs(s.maxCyc));
+    for (uint8_t b = 0; b < LoopProfiler::kBins; b++) {
+        out[17 + 2 * b] = (uint8_t)(s.hist[b] & 0xFF);
+        out[18 + 2 * b] = (uint8_t)(s.hist[b] >> 8);
+    }
+    return kLoopProfileLen;
+}
+#endif
+
+void GrowBedNode::begin(MotionController* const* motions, uint8_t count) {
+    _motionCount = (count > kMaxChannels) ? kMaxChannels : count;
+    for (uint8_t i = 0; i < _motionCount; i++) _motions[i] = motions[i];
+}
 
 bool GrowBedNode::handleCommand(const platform::envelope::Envelope& cmd,
                                platform::envelope::Envelope& outReply,
                                uint8_t* replyDataBuf, uint16_t replyDataMax) {
-    if (!_motion) return false;
+    if (_motionCount == 0) return false;
     if (cmd.kind != platform::envelope::Kind::Cmd) return false;
+    // status: 0 ok, 1 UnknownCap, 2 UnknownMsgId, 3 BadLength, 4 UnknownChannel.
+    // Program steps are queued asynchronously; refusals show up in programRejects.
 
     outReply.capId = cmd.capId;
     outReply.kind = platform::envelope::Kind::Ack;
@@ -19,10 +78,17 @@ bool GrowBedNode::handleCommand(const platform::envelope::Envelope& cmd,
     outReply.flags = 0;
     outReply.hasSeq = cmd.hasSeq;
     outReply.seq = cmd.seq;
+    outReply.hasChannel = cmd.hasChannel;
+    outReply.channel = cmd.channel;
 
     uint8_t status = 0;
+    uint16_t replyLen = 1;   // status byte + any reply payload written after it
+    MotionController* const motion = motionFor(cmd.channel);
 
-    if (cmd.capId == platform::capability::CAP_MOTION_LINEAR) {
+    if (!motion) {
+        outReply.kind = platform::envelope::Kind::Err;
+        status = 4; // UnknownChannel
+    } else if (cmd.capId == platform::capability::CAP_MOTION_LINEAR) {
         switch (cmd.msgId) {
             case platform::capability::ML_START:
             case platform::capability::ML_STOP:
@@ -33,6 +99,74 @@ bool GrowBedNode::handleCommand(const platform::envelope::Envelope& cmd,
             case platform::capability::ML_SET_DWELL:
                 status = 0; // TODO parse/apply
                 break;
+            case platform::capability::ML_PROG_CLEAR:
+                motion->requestProgramClear();
+                break;
+            case platform::capability::ML_PROG_MOVE_TO:
+                if (cmd.dataLen < 6) { status = 3; break; }
+                motion->requestProgramMoveTo((long)(int32_t)rdU32(cmd.data), (float)rdU16(cmd.data + 4));
+                break;
+            case platform::capability::ML_PROG_MOVE_FRAC:
+                if (cmd.dataLen < 4) { status = 3; break; }
+                motion->requestProgramMoveToFraction(rdU16(cmd.data), (float)rdU16(cmd.data + 2));
+                break;
+            case platform::capability::ML_PROG_HOLD:
+                if (cmd.dataLen < 4) { status = 3; break; }
+                motion->requestProgramHold(rdU32(cmd.data));
+                break;
+            case platform::capability::ML_PROG_SWEEP:
+                if (cmd.dataLen < 12) { status = 3; break; }
+                motion->requestProgramSweep((long)(int32_t)rdU32(cmd.data + 1),
+                                             (long)(int32_t)rdU32(cmd.data + 5),
+                                             cmd.data[9], cmd.data[0] != 0,
+                                             (float)rdU16(cmd.data + 10));
+                break;
+            case platform::capability::ML_PROG_RUN:
+                motion->requestProgramRun();
+                break;
+            case platform::capability::ML_AUTO_TUNE:
+                if (cmd.dataLen < 1) { status = 3; break; }
+                if (cmd.data[0] == 0) {
+                    motion->stopAutoTune();
+                } else {
+                    MotionAutoTunePolicy p;
+                    if (cmd.dataLen >= 5) {
+                        p.stepPercent = cmd.data[1];
+                        p.marginPercent = cmd.data[2];
+                        p.spsCeiling = (float)rdU16(cmd.data + 3);
+                    }
+                    motion->startAutoTune(p);
+                }
+                break;
+            case platform::capability::ML_SET_ZONE:
+                if (cmd.dataLen < 7 || cmd.data[0] >= kMotionZoneCount) { status = 3; break; }
+                motion->requestSetZone(cmd.data[0], rdU16(cmd.data + 1), rdU16(cmd.data + 3),
+                                       (float)rdU16(cmd.data + 5));
+                markPersistDirty();
+                break;
+            default:
+                outReply.kind = platform::envelope::Kind::Err;
+                status = 2; // UnknownMsgId
+                break;
+        }
+    } else if (cmd.capId == platform::capability::CAP_DIAGNOSTICS_HEALTH) {
+        switch (cmd.msgId) {
+#if LOOP_PROFILER
+            case platform::capability::DH_LOOP_PROFILE:
+                if (cmd.dataLen < 1) { status = 3; break; }
+                if (cmd.data[0] == 0xFF) { LoopProfiler::reset(); break; }
+                if (cmd.data[0] >= LoopProfiler::kPhases) { status = 3; break; }
+                if (replyDataBuf && replyDataMax >= 1 + kLoopProfileLen) {
+                    replyLen += writeLoopProfile(replyDataBuf + 1, (ProfPhase)cmd.data[0]);
+                }
+                break;
+#endif
+            case platform::capability::DH_STEP_JITTER:
+                if (replyDataBuf && replyDataMax >= 1 + kStepJitterLen) {
+                    replyLen += writeStepJitter(replyDataBuf + 1, motion->status());
+                }
+                if (cmd.dataLen >= 1 && cmd.data[0] == 1) motion->resetStepTimingStats();
+                break;
             default:
                 outReply.kind = platform::envelope::Kind::Err;
                 status = 2; // UnknownMsgId
@@ -43,10 +177,12 @@ bool GrowBedNode::handleCommand(const platform::envelope::Envelope& cmd,
         status = 1; // UnknownCap
     }
 
+    if (status == 3) outReply.kind = platform::envelope::Kind::Err;
+
     if (replyDataBuf && replyDataMax >= 1) {
         replyDataBuf[0] = status;
         outReply.data = replyDataBuf;
-        outReply.dataLen = 1;
+        outReply.dataLen = (status == 0) ? replyLen : 1;
     } else {
         outReply.data = nullptr;
         outReply.dataLen = 0;
@@ -55,10 +191,11 @@ bool GrowBedNode::handleCommand(const platform::envelope::Envelope& cmd,
 }
 
 bool GrowBedNode::buildTelemetryBasic(platform::envelope::Envelope& outTel,
-                                     uint8_t* dataBuf, uint16_t dataMax) {
-    if (!_motion || !dataBuf || dataMax < 8) return false;
+                                     uint8_t* dataBuf, uint16_t dataMax, uint8_t channel) {
+    MotionController* const motion = motionFor(channel);
+    if (!motion || !dataBuf || dataMax < 8) return false;
 
-    const auto& st = _motion->status();
+    const MotionHotStatus st = motion->hotStatus();
     dataBuf[0] = (uint8_t)st.state;
     dataBuf[1] = (uint8_t)st.err;
     uint32_t up = millis();
@@ -75,6 +212,7 @@ bool GrowBedNode::buildTelemetryBasic(platform::envelope::Envelope& outTel,
     outTel.flags = 0;
     outTel.hasSeq = false;
     outTel.seq = 0;
+    setChannel(outTel, channel);
     outTel.data = dataBuf;
     outTel.dataLen = 8;
     return true;
@@ -82,8 +220,10 @@ bool GrowBedNode::buildTelemetryBasic(platform::envelope::Envelope& outTel,
 
 bool GrowBedNode::buildEventAlert(platform::envelope::Envelope& outEvt,
                                  uint8_t* dataBuf, uint16_t dataMax,
-                                 uint8_t faultCode, uint32_t uptimeMs, uint32_t cycles) {
+                                 uint8_t faultCode, uint32_t uptimeMs, uint32_t cycles,
+                                 uint8_t channel) {
     if (!dataBuf || dataMax < 13) return false;
+    MotionController* const motion = motionFor(channel);
 
     // DATA:
     // 0: faultCode
@@ -92,7 +232,7 @@ bool GrowBedNode::buildEventAlert(platform::envelope::Envelope& outEvt,
     // 6..9: cycles (u32)
     // 10..12: reserved
     dataBuf[0] = faultCode;
-    dataBuf[1] = _motion ? (uint8_t)_motion->status().state : 0;
+    dataBuf[1] = motion ? (uint8_t)motion->status().state : 0;
 
     dataBuf[2] = (uint8_t)(uptimeMs & 0xFF);
     dataBuf[3] = (uint8_t)((uptimeMs >> 8) & 0xFF);
@@ -110,10 +250,11 @@ bool GrowBedNode::buildEventAlert(platform::envelope::Envelope& outEvt,
 
     outEvt.capId = platform::capability::CAP_DIAGNOSTICS_HEALTH;
     outEvt.kind = platform::envelope::Kind::Evt;
-    outEvt.msgId = 0x10; // ALERT
+    outEvt.msgId = platform::capability::DH_ALERT;
     outEvt.flags = 0;
     outEvt.hasSeq = false;
     outEvt.seq = 0;
+    setChannel(outEvt, channel);
     outEvt.data = dataBuf;
     outEvt.dataLen = 13;
     return true;
@@ -123,7 +264,8 @@ bool GrowBedNode::buildEventAlert(platform::envelope::Envelope& outEvt,
 bool GrowBedNode::buildEventFactoryValidation(platform::envelope::Envelope& outEvt,
                          uint8_t* dataBuf, uint16_t dataMax,
                          uint32_t seq, bool pass, uint8_t failCode, uint8_t failStep,
-                         uint32_t durationMs, uint32_t uptimeMs, uint32_t cycles) {
+                         uint32_t durationMs, uint32_t uptimeMs, uint32_t cycles,
+                         uint8_t channel) {
     if (!dataBuf || dataMax < 21) return false;
 
     // DATA:
@@ -164,13 +306,56 @@ bool GrowBedNode::buildEventFactoryValidation(platform::envelope::Envelope& outE
 
     outEvt.capId = platform::capability::CAP_DIAGNOSTICS_HEALTH;
     outEvt.kind = platform::envelope::Kind::Evt;
-    outEvt.msgId = 0x11; // FACTORY_VALIDATION
+    outEvt.msgId = platform::capability::DH_FACTORY_VALIDATION;
     outEvt.flags = 0;
     outEvt.hasSeq = false;
     outEvt.seq = 0;
+    setChannel(outEvt, channel);
     outEvt.data = dataBuf;
     outEvt.dataLen = 21;
     return true;
 }
 
+bool GrowBedNode::buildEventAutoTune(platform::envelope::Envelope& outEvt,
+                         uint8_t* dataBuf, uint16_t dataMax,
+                         uint32_t seq, uint8_t result, uint8_t stagesPassed,
+                         uint32_t maxSps, uint32_t accel, uint8_t channel) {
+    if (!dataBuf || dataMax < 14) return false;
+
+    // DATA:
+    // 0..3: seq (u32)
+    // 4: result (AutoTuneResult)
+    // 5: stages passed
+    // 6..9: maxSps (u32, committed)
+    // 10..13: accel (u32, committed)
+    dataBuf[0] = (uint8_t)(seq & 0xFF);
+    dataBuf[1] = (uint8_t)((seq >> 8) & 0xFF);
+    dataBuf[2] = (uint8_t)((seq >> 16) & 0xFF);
+    dataBuf[3] = (uint8_t)((seq >> 24) & 0xFF);
+
+    dataBuf[4] = result;
+    dataBuf[5] = stagesPassed;
+
+    dataBuf[6] = (uint8_t)(maxSps & 0xFF);
+    dataBuf[7] = (uint8_t)((maxSps >> 8) & 0xFF);
+    dataBuf[8] = (uint8_t)((maxSps >> 16) & 0xFF);
+    dataBuf[9] = (uint8_t)((maxSps >> 24) & 0xFF);
+
+    dataBuf[10] = (uint8_t)(accel & 0xFF);
+    dataBuf[11] = (uint8_t)((accel >> 8) & 0xFF);
+    dataBuf[12] = (uint8_t)((accel >> 16) & 0xFF);
+    dataBuf[13] = (uint8_t)((accel >> 24) & 0xFF);
+
+    outEvt.capId = platform::capability::CAP_DIAGNOSTICS_HEALTH;
+    outEvt.kind = platform::envelope::Kind::Evt;
+    outEvt.msgId = platform::capability::DH_AUTO_TUNE;
+    outEvt.flags = 0;
+    outEvt.hasSeq = false;
+    outEvt.seq = 0;
+    setChannel(outEvt, channel);
+    outEvt.data = dataBuf;
+    outEvt.dataLen = 14;
+    return true;
+}
+
 } // namespace product::growbed
@@ -8,28 +8,50 @@ namespace product::growbed {
 
 class GrowBedNode {
 public:
-    void begin(MotionController* motion);
+    static constexpr uint8_t kMaxChannels = 3;
+
+    void begin(MotionController* motion) { begin(&motion, 1); }
+    // motions[i] serves envelope channel i (commands without a channel byte go to 0).
+    void begin(MotionController* const* motions, uint8_t count);
 
     bool handleCommand(const platform::envelope::Envelope& cmd,
                        platform::envelope::Envelope& outReply,
                        uint8_t* replyDataBuf, uint16_t replyDataMax);
 
     bool buildTelemetryBasic(platform::envelope::Envelope& outTel,
-                             uint8_t* dataBuf, uint16_t dataMax);
+                             uint8_t* dataBuf, uint16_t dataMax, uint8_t channel = 0);
 
     // Event: alert/fault notification to LineBed
     bool buildEventAlert(platform::envelope::Envelope& outEvt,
                          uint8_t* dataBuf, uint16_t dataMax,
-                         uint8_t faultCode, uint32_t uptimeMs, uint32_t cycles);
+                         uint8_t faultCode, uint32_t uptimeMs, uint32_t cycles,
+                         uint8_t channel = 0);
 
     // Event: factory validation result
     bool buildEventFactoryValidation(platform::envelope::Envelope& outEvt,
                          uint8_t* dataBuf, uint16_t dataMax,
                          uint32_t seq, bool pass, uint8_t failCode, uint8_t failStep,
-                         uint32_t durationMs, uint32_t uptimeMs, uint32_t cycles);
+                         uint32_t durationMs, uint32_t uptimeMs, uint32_t cycles,
+                         uint8_t channel = 0);
+
+    // Event: auto tune finished (config committed unless aborted)
+    bool buildEventAutoTune(platform::envelope::Envelope& outEvt,
+                         uint8_t* dataBuf, uint16_t dataMax,
+                         uint32_t seq, uint8_t result, uint8_t stagesPassed,
+                         uint32_t maxSps, uint32_t accel, uint8_t channel = 0);
 
 private:
-    MotionController* _motion {nullptr};
+    MotionController* motionFor(uint8_t channel) const {
+        return (channel < _motionCount) ? _motions[channel] : nullptr;
+    }
+    // channel 0 goes out without the channel byte (single-bed wire format unchanged)
+    static void setChannel(platform::envelope::Envelope& env, uint8_t channel) {
+        env.hasChannel = (channel != 0);
+        env.channel = channel;
+    }
+
+    MotionController* _motions[kMaxChannels] {};
+    uint8_t _motionCount {0};
 };
 
 } // namespace product::growbed
@@ -0,0 +1,25 @@
+#pragma once
+#include <Arduino.h>
+#include <hardware/structs/systick.h>
+
+// Cycle counter for the on-target benchmarks: SysTick at clk_sys, 24 bit, counting down.
+// Spans must stay below 2^24 cycles (~84 ms at 200 MHz); time batches, not whole runs.
+namespace bench {
+
+inline void cyclesBegin() {
+    systick_hw->rvr = 0x00FFFFFFu;
+    systick_hw->cvr = 0;
+    systick_hw->csr = (1u << 2) | 1u;   // processor clock, enabled, no interrupt
+}
+
+inline uint32_t cyclesNow() { return systick_hw->cvr; }
+
+inline uint32_t cyclesSince(uint32_t t0) { return (t0 - systick_hw->cvr) & 0x00FFFFFFu; }
+
+// Keeps results alive without letting the optimizer fold the loop.
+inline void sink(uint32_t v) {
+    static volatile uint32_t s;
+    s = s + v;
+}
+
+} // namespace bench
@@ -0,0 +1,96 @@
+// On-target cycles/tick comparison: float speed math (before Q16.16) vs the integer
+// path in MotionController (pio test -e pico_bench -f embedded/test_speed_math).
+//
+// One "tick" = what every tick() did per moving state: ramp the speed by accel * dt with
+// the brake-distance check, then derive the step interval. The float variant is the
+// pre-Q16 code kept verbatim here; the Q16 variant uses the same MotionMath helpers
+// as rampSpeed()/setSpeed(). For the whole tick() in the firmware, build with
+// LOOP_PROFILER=1 and read the motion phase.
+#include <Arduino.h>
+#include <unity.h>
+#include "app/controllers/MotionMath.h"
+#include "../bench_cycles.h"
+
+using namespace motion_math;
+
+static constexpr uint32_t kTicks = 1000;
+
+// inputs through volatiles so nothing is constant-folded
+static volatile float gMaxSpsF = 3000.0f;
+static volatile float gMinSpsF = 1200.0f;
+static volatile float gAccelF = 600.0f;
+static volatile uint32_t gTravel = 20000;
+
+static uint32_t gFloatCycles = 0;
+static uint32_t gQ16Cycles = 0;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_float_tick(void) {
+    const float vmax = gMaxSpsF, vmin = gMinSpsF, a = gAccelF;
+    float v = vmin;
+    uint32_t moved = 0;
+    const uint32_t t0 = bench::cyclesNow();
+    for (uint32_t i = 0; i < kTicks; i++) {
+        // rampSpeed() (1 ms dt) + stepDue() interval, as before the Q16 change
+        const float dt = 1.0f / 1000.0f;
+        float desired = vmax;
+        const uint32_t remaining = gTravel - moved;
+        const float brake = (v * v) / (2.0f * a);
+        if ((float)remaining <= brake) desired = vmin;
+        if (v < desired) { v += a * dt; if (v > desired) v = desired; }
+        else if (v > desired) { v -= a * dt; if (v < desired) v = desired; }
+        const float sps = v > 1.0f ? v : 1.0f;
+        const uint32_t iv = (uint32_t)(1000000.0f / sps);
+        moved += 3;
+        bench::sink(iv);
+    }
+    gFloatCycles = bench::cyclesSince(t0) / kTicks;
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "float: %lu cycles/tick", (unsigned long)gFloatCycles);
+    TEST_MESSAGE(msg);
+}
+
+static void test_q16_tick(void) {
+    const q16 vmax = toQ16(gMaxSpsF), vmin = toQ16(gMinSpsF), accelQ = toQ16(gAccelF);
+    const uint32_t accel = toInt(accelQ);
+    const q16 dv = accelPerMs(accelQ);
+    q16 v = vmin;
+    uint32_t moved = 0;
+    const uint32_t t0 = bench::cyclesNow();
+    for (uint32_t i = 0; i < kTicks; i++) {
+        // rampSpeed() (1 ms dt) + setSpeed() interval cache
+        q16 desired = vmax;
+        const uint32_t remaining = gTravel - moved;
+        if (remaining <= brakeSteps(v, accel)) desired = vmin;
+        if (v < desired) v = (desired - v > dv) ? v + dv : desired;
+        else if (v > desired) v = (v - desired > dv) ? v - dv : desired;
+        const uint32_t iv = intervalUs(v);
+        moved += 3;
+        bench::sink(iv);
+    }
+    gQ16Cycles = bench::cyclesSince(t0) / kTicks;
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "q16  : %lu cycles/tick", (unsigned long)gQ16Cycles);
+    TEST_MESSAGE(msg);
+}
+
+static void test_q16_is_cheaper(void) {
+    TEST_ASSERT_GREATER_THAN_UINT32(0, gQ16Cycles);
+    TEST_ASSERT_LESS_THAN_UINT32(gFloatCycles, gQ16Cycles);
+}
+
+void setup() {
+    delay(2000);   // USB serial
+    bench::cyclesBegin();
+    UNITY_BEGIN();
+    RUN_TEST(test_float_tick);
+    RUN_TEST(test_q16_tick);
+    RUN_TEST(test_q16_is_cheaper);
+    UNITY_END();
+}
+
+void loop() {}
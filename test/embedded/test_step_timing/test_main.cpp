@@ -0,0 +1,117 @@
+// On-target before/after comparison for the timer-alarm step scheduler
+// (pio test -e pico_bench -f embedded/test_step_timing).
+//
+// Same stroke, same load: 2000 steps at 400 us (2500 sps) while the "loop" blocks for
+// kStallUs every kStallEveryUs, roughly one full-frame OLED sendBuffer per UI refresh.
+// - before: legacy polled stepping, next step one interval after the late one
+// - after : StepGenHal_Alarm fed from the same loop (deadline-based ISR)
+// Reported per variant: worst lateness against the ideal schedule and the total stroke
+// time against the ideal 2000 x 400 us.
+//
+// Drives PIN_STEP: run with the driver disabled or the motor unplugged.
+#include <Arduino.h>
+#include <unity.h>
+#include "config/PinMap.h"
+#include "hal/StepGenHal_Alarm.h"
+
+static constexpr uint32_t kSteps = 2000;
+static constexpr uint32_t kIntervalUs = 400;
+static constexpr uint32_t kStallUs = 5000;
+static constexpr uint32_t kStallEveryUs = 20000;
+
+struct Result {
+    uint32_t lateMaxUs = 0;
+    uint32_t strokeUs = 0;
+};
+
+static Result gPolled;
+static Result gAlarm;
+
+// the simulated UI: blocks for kStallUs once per kStallEveryUs
+static void loadTick(uint32_t& nextStallUs) {
+    const uint32_t now = micros();
+    if ((int32_t)(now - nextStallUs) < 0) return;
+    delayMicroseconds(kStallUs);
+    nextStallUs = now + kStallEveryUs;
+}
+
+static void pulse() {
+    digitalWrite(PIN_STEP, HIGH);
+    delayMicroseconds(3);
+    digitalWrite(PIN_STEP, LOW);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_polled_under_load(void) {
+    pinMode(PIN_STEP, OUTPUT);
+    uint32_t nextStallUs = micros() + kStallEveryUs;
+    const uint32_t t0 = micros();
+    uint32_t lastUs = t0;
+    for (uint32_t n = 0; n < kSteps;) {
+        loadTick(nextStallUs);
+        const uint32_t now = micros();
+        if (now - lastUs < kIntervalUs) continue;
+        // ideal schedule: step n is due at t0 + n * interval
+        const uint32_t late = now - (t0 + n * kIntervalUs);
+        if ((int32_t)late > 0 && late > gPolled.lateMaxUs) gPolled.lateMaxUs = late;
+        pulse();
+        lastUs = now;
+        n++;
+    }
+    gPolled.strokeUs = micros() - t0;
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "polled: late max %lu us, stroke %lu us (ideal %lu)",
+             (unsigned long)gPolled.lateMaxUs, (unsigned long)gPolled.strokeUs,
+             (unsigned long)(kSteps * kIntervalUs));
+    TEST_MESSAGE(msg);
+}
+
+static void test_alarm_under_load(void) {
+    static StepGenHal_Alarm gen(PIN_STEP);
+    TEST_ASSERT_TRUE(gen.begin());
+    gen.resetTimingStats();
+
+    uint32_t nextStallUs = micros() + kStallEveryUs;
+    uint32_t pushed = 0;
+    uint32_t emitted = 0;
+    const uint32_t t0 = micros();
+    while (emitted < kSteps) {
+        loadTick(nextStallUs);
+        // keep more than one stall worth of steps queued, as runSteps() does (kStepLeadMs)
+        while (pushed < kSteps && gen.freeSlots() > 0 && gen.queued() < 32) {
+            gen.push(kIntervalUs);
+            pushed++;
+        }
+        emitted += gen.takeEmitted();
+    }
+    gAlarm.strokeUs = micros() - t0;
+    gAlarm.lateMaxUs = gen.maxLateUs();
+    gen.flush();
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "alarm : late max %lu us, stroke %lu us (ideal %lu)",
+             (unsigned long)gAlarm.lateMaxUs, (unsigned long)gAlarm.strokeUs,
+             (unsigned long)(kSteps * kIntervalUs));
+    TEST_MESSAGE(msg);
+}
+
+static void test_alarm_beats_polled(void) {
+    // the stall has to show up in the polled run, and not in the ISR-timed one
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(kStallUs / 2, gPolled.lateMaxUs);
+    TEST_ASSERT_LESS_THAN_UINT32(gPolled.lateMaxUs, gAlarm.lateMaxUs);
+    TEST_ASSERT_LESS_THAN_UINT32(gPolled.strokeUs, gAlarm.strokeUs);
+}
+
+void setup() {
+    delay(2000);   // USB serial
+    UNITY_BEGIN();
+    RUN_TEST(test_polled_under_load);
+    RUN_TEST(test_alarm_under_load);
+    RUN_TEST(test_alarm_beats_polled);
+    UNITY_END();
+}
+
+void loop() {}
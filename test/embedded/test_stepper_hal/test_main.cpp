@@ -0,0 +1,78 @@
+// On-target cycles comparison of the two DRV8825 HALs
+// (pio test -e pico_bench -f embedded/test_stepper_hal).
+//
+// Per polled step tick() calls enable(true) and setDir() and then stepPulse(). Both HALs
+// run that sequence on the channel-0 pins; the 3 us STEP high time is the same busy wait
+// in both and is subtracted, so the numbers are pure HAL overhead.
+// MOTION_STEPPER_SIO defaults to 0 until these numbers are in.
+//
+// Drives EN/DIR/STEP: run with the motor unplugged.
+#include <Arduino.h>
+#include <unity.h>
+#include <hardware/clocks.h>
+#include "hal/StepperHal_Drv8825.h"
+#include "hal/StepperHal_Sio.h"
+#include "../bench_cycles.h"
+
+static constexpr uint32_t kIters = 1000;
+
+static uint32_t gDigitalWriteCycles = 0;
+static uint32_t gSioCycles = 0;
+
+// cycles of the 3 us STEP high time included in every stepPulse()
+static uint32_t pulseWaitCycles() { return 3u * (clock_get_hz(clk_sys) / 1000000u); }
+
+template <typename Hal>
+static uint32_t cyclesPerStep(Hal& hal) {
+    hal.begin();
+    bool dir = false;
+    const uint32_t t0 = bench::cyclesNow();
+    for (uint32_t i = 0; i < kIters; i++) {
+        hal.enable(true);
+        if ((i & 63) == 0) dir = !dir;   // a reversal now and then, as at the ends
+        hal.setDir(dir);
+        hal.stepPulse();
+    }
+    const uint32_t perStep = bench::cyclesSince(t0) / kIters;
+    hal.enable(false);
+    const uint32_t wait = pulseWaitCycles();
+    return perStep > wait ? perStep - wait : 0;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_digitalwrite_hal(void) {
+    static StepperHal_Drv8825 hal(kMotionPins[0]);
+    gDigitalWriteCycles = cyclesPerStep(hal);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "digitalWrite HAL: %lu cycles/step", (unsigned long)gDigitalWriteCycles);
+    TEST_MESSAGE(msg);
+}
+
+static void test_sio_hal(void) {
+    static StepperHal_Sio<> hal;   // compile-time pin masks (DefaultStepperPins)
+    gSioCycles = cyclesPerStep(hal);
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "SIO HAL: %lu cycles/step, %lu EN/DIR/MS writes",
+             (unsigned long)gSioCycles, (unsigned long)hal.pinWrites());
+    TEST_MESSAGE(msg);
+}
+
+static void test_sio_is_cheaper(void) {
+    TEST_ASSERT_LESS_THAN_UINT32(gDigitalWriteCycles, gSioCycles);
+}
+
+void setup() {
+    delay(2000);   // USB serial
+    bench::cyclesBegin();
+    UNITY_BEGIN();
+    RUN_TEST(test_digitalwrite_hal);
+    RUN_TEST(test_sio_hal);
+    RUN_TEST(test_sio_is_cheaper);
+    UNITY_END();
+}
+
+void loop() {}
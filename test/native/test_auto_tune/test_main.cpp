@@ -0,0 +1,93 @@
+// Host check of the auto tune search (pio test -e native): stage progression and the
+// config each result leaves behind. MotionController ends the search with Fault from
+// fault() and with Aborted from any stop; these cases pin what that puts back.
+#include <unity.h>
+#include "app/controllers/AutoTuneSearch.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static MotionAutoTunePolicy policy() {
+    MotionAutoTunePolicy p;
+    p.stepPercent = 10;
+    p.hitsPerStage = 2;
+    p.marginPercent = 20;
+    p.maxStages = 12;
+    p.lostStepLimit = 32;
+    p.spsCeiling = 20000.0f;
+    return p;
+}
+
+static void passStage(AutoTuneSearch& s) {
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)AutoTuneSearch::Hit::Counted, (uint8_t)s.endHit(3));
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)AutoTuneSearch::Hit::NextStage, (uint8_t)s.endHit(-3));
+}
+
+static void test_fault_keeps_last_passing_stage(void) {
+    AutoTuneSearch s;
+    s.begin(policy(), 4000.0f, 2000.0f, 16000.0f);
+    passStage(s);   // 4000 passes, 4400 runs
+    passStage(s);   // 4400 passes, 4840 runs
+    TEST_ASSERT_EQUAL_UINT8(2, s.stage);
+    TEST_ASSERT_EQUAL_FLOAT(4400.0f, s.passSps);
+
+    // the 4840 stage faults mid-stage: 4400/2200 minus 20%
+    float sps = 0, accel = 0;
+    s.finish(AutoTuneResult::Fault, 200.0f, sps, accel);
+    TEST_ASSERT_FALSE(s.running);
+    TEST_ASSERT_EQUAL_FLOAT(3520.0f, sps);
+    TEST_ASSERT_EQUAL_FLOAT(1760.0f, accel);
+    TEST_ASSERT_EQUAL_UINT8(2, s.passed);
+}
+
+static void test_fault_in_first_stage_derates_base(void) {
+    AutoTuneSearch s;
+    s.begin(policy(), 4000.0f, 2000.0f, 16000.0f);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)AutoTuneSearch::Hit::Counted, (uint8_t)s.endHit(0));
+
+    float sps = 0, accel = 0;
+    s.finish(AutoTuneResult::Fault, 200.0f, sps, accel);
+    TEST_ASSERT_EQUAL_FLOAT(3200.0f, sps);
+    TEST_ASSERT_EQUAL_FLOAT(1600.0f, accel);
+}
+
+static void test_abort_restores_base(void) {
+    AutoTuneSearch s;
+    s.begin(policy(), 4000.0f, 2000.0f, 16000.0f);
+    passStage(s);
+
+    float sps = 0, accel = 0;
+    s.finish(AutoTuneResult::Aborted, 200.0f, sps, accel);
+    TEST_ASSERT_FALSE(s.running);
+    TEST_ASSERT_EQUAL_FLOAT(4000.0f, sps);
+    TEST_ASSERT_EQUAL_FLOAT(2000.0f, accel);
+}
+
+static void test_lost_steps_end_the_stage(void) {
+    AutoTuneSearch s;
+    s.begin(policy(), 4000.0f, 2000.0f, 16000.0f);
+    passStage(s);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)AutoTuneSearch::Hit::LostSteps, (uint8_t)s.endHit(-33));
+    TEST_ASSERT_EQUAL_FLOAT(4000.0f, s.passSps);
+}
+
+static void test_ceiling_is_capped_to_backend_max(void) {
+    AutoTuneSearch s;
+    s.begin(policy(), 4000.0f, 2000.0f, 4500.0f);
+    TEST_ASSERT_EQUAL_FLOAT(4500.0f, s.policy.spsCeiling);
+    passStage(s);   // 4400 <= 4500
+    s.endHit(0);
+    // 4840 would exceed the ceiling: 4400 is the last stage
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)AutoTuneSearch::Hit::Ceiling, (uint8_t)s.endHit(0));
+    TEST_ASSERT_EQUAL_FLOAT(4400.0f, s.passSps);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fault_keeps_last_passing_stage);
+    RUN_TEST(test_fault_in_first_stage_derates_base);
+    RUN_TEST(test_abort_restores_base);
+    RUN_TEST(test_lost_steps_end_the_stage);
+    RUN_TEST(test_ceiling_is_capped_to_backend_max);
+    return UNITY_END();
+}
@@ -0,0 +1,72 @@
+// Host check of MotionPlanner's S-curve ramps (pio test -e native).
+// Walks whole strokes step by step: the last planned step must be taken at vEnd, and
+// the decel into the end must never be faster than the trapezoid with the same accel
+// (the hall approach speed may not depend on the profile).
+#include <unity.h>
+#include <math.h>
+#include "app/controllers/MotionPlanner.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+struct Walk {
+    uint32_t lastSps = 0;
+    uint32_t peakSps = 0;
+    uint32_t overTrapezoid = 0;   // decel steps above sqrt(vEnd^2 + 2*a*(left-1))
+};
+
+static Walk walk(MotionPlanner& p, uint32_t steps, uint32_t vEnd, uint32_t accel) {
+    Walk w;
+    for (uint32_t i = 0; i < steps; i++) {
+        p.nextIntervalUs();
+        const uint32_t v = p.currentSps();
+        if (v > w.peakSps) w.peakSps = v;
+        const uint32_t left = steps - i;
+        const double cap = sqrt((double)vEnd * vEnd + 2.0 * accel * (left - 1));
+        if (v > (uint32_t)cap + 1) w.overTrapezoid++;
+        w.lastSps = v;
+    }
+    return w;
+}
+
+static void test_jerk_dominated_decel_ends_at_vend(void) {
+    // steep accel against jerk: the jerk phases are a large part of each ramp
+    MotionPlanner p;
+    const uint32_t steps = 20000;
+    TEST_ASSERT_TRUE(p.plan(steps, 1200, 8000, 1200, 5000, 2000000));
+    const Walk w = walk(p, steps, 1200, 5000);
+
+    TEST_ASSERT_EQUAL_UINT32(8000, w.peakSps);
+    TEST_ASSERT_EQUAL_UINT32(1200, w.lastSps);
+    TEST_ASSERT_EQUAL_UINT32(0, w.overTrapezoid);
+}
+
+static void test_short_jerk_limited_stroke_ends_at_vend(void) {
+    // low jerk, short stroke: accel never reaches its limit and the peak is searched
+    MotionPlanner p;
+    const uint32_t steps = 1500;
+    TEST_ASSERT_TRUE(p.plan(steps, 1200, 6000, 1200, 4000, 20000));
+    const Walk w = walk(p, steps, 1200, 4000);
+
+    TEST_ASSERT_LESS_THAN_UINT32(6000, w.peakSps);
+    TEST_ASSERT_EQUAL_UINT32(1200, w.lastSps);
+    TEST_ASSERT_EQUAL_UINT32(0, w.overTrapezoid);
+}
+
+static void test_trapezoid_ends_at_vend(void) {
+    MotionPlanner p;
+    const uint32_t steps = 20000;
+    TEST_ASSERT_TRUE(p.plan(steps, 1200, 8000, 1200, 5000));
+    const Walk w = walk(p, steps, 1200, 5000);
+
+    TEST_ASSERT_EQUAL_UINT32(1200, w.lastSps);
+    TEST_ASSERT_EQUAL_UINT32(0, w.overTrapezoid);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_jerk_dominated_decel_ends_at_vend);
+    RUN_TEST(test_short_jerk_limited_stroke_ends_at_vend);
+    RUN_TEST(test_trapezoid_ends_at_vend);
+    return UNITY_END();
+}
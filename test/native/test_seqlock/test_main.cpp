@@ -0,0 +1,118 @@
+// SeqLock stress test (pio test -e native).
+// One writer thread republishes a MotionStatus-sized record as fast as it can while
+// reader threads copy it; every copy a reader accepts must be internally consistent
+// (all words from the same write) and versions must never go backwards.
+// Runs for a fixed time so a multi-core host interleaves writer and readers a lot.
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "platform/util/SeqLock.h"
+
+struct Record {
+    uint32_t gen;
+    uint32_t words[60];   // ~ sizeof(MotionStatus): a torn copy spans many cache lines
+    uint32_t check;
+};
+
+static Record make(uint32_t gen) {
+    Record r;
+    r.gen = gen;
+    for (uint32_t i = 0; i < 60; i++) r.words[i] = gen * 2654435761u + i;
+    r.check = ~gen;
+    return r;
+}
+
+static bool consistent(const Record& r) {
+    if (r.check != ~r.gen) return false;
+    for (uint32_t i = 0; i < 60; i++) {
+        if (r.words[i] != r.gen * 2654435761u + i) return false;
+    }
+    return true;
+}
+
+static constexpr uint32_t kMinWrites = 200000;
+static constexpr auto kRunTime = std::chrono::milliseconds(300);
+static constexpr int kReaders = 3;
+
+// writes generations 1.. until both the time and the count are reached; returns the last
+static uint32_t writeFor(platform::util::SeqLock<Record>& lock) {
+    const auto end = std::chrono::steady_clock::now() + kRunTime;
+    uint32_t g = 0;
+    while (g < kMinWrites || std::chrono::steady_clock::now() < end) lock.write(make(++g));
+    return g;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_readers_never_see_torn_copies(void) {
+    static platform::util::SeqLock<Record> lock;
+    lock.write(make(0));
+
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> torn{0};
+    std::atomic<uint32_t> backwards{0};
+    std::atomic<uint32_t> reads{0};
+
+    auto reader = [&]() {
+        uint32_t lastGen = 0;
+        Record r;
+        while (!done.load(std::memory_order_acquire)) {
+            lock.read(r);
+            if (!consistent(r)) torn++;
+            if (r.gen < lastGen) backwards++;
+            lastGen = r.gen;
+            reads++;
+        }
+    };
+
+    std::thread readers[kReaders];
+    for (auto& t : readers) t = std::thread(reader);
+    const uint32_t lastGen = writeFor(lock);
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) t.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_EQUAL_UINT32(0, backwards.load());
+    TEST_ASSERT_GREATER_THAN_UINT32(0, reads.load());
+
+    Record last;
+    lock.read(last);
+    TEST_ASSERT_EQUAL_UINT32(lastGen, last.gen);
+    TEST_ASSERT_EQUAL_UINT32(2 * (lastGen + 1), lock.version());
+}
+
+static void test_try_read_rejects_write_in_progress(void) {
+    // a reader that lands inside write() (odd seq) must fail instead of copying
+    static platform::util::SeqLock<Record> lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> accepted{0};
+    std::atomic<uint32_t> rejected{0};
+    std::atomic<uint32_t> torn{0};
+
+    std::thread rd([&]() {
+        Record r;
+        while (!done.load(std::memory_order_acquire)) {
+            if (lock.tryRead(r)) {
+                accepted++;
+                if (!consistent(r) && r.gen != 0) torn++;
+            } else {
+                rejected++;
+            }
+        }
+    });
+    writeFor(lock);
+    done.store(true, std::memory_order_release);
+    rd.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_GREATER_THAN_UINT32(0, accepted.load());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_readers_never_see_torn_copies);
+    RUN_TEST(test_try_read_rejects_write_in_progress);
+    return UNITY_END();
+}
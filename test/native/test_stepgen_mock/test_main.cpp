@@ -0,0 +1,107 @@
+// Host check of the step interval stream (pio test -e native).
+// StepGenHal_Mock emits a pulse per pushed interval on a simulated clock; the logged
+// gaps must reproduce the pushed intervals exactly, across underruns and flushes, and
+// a planner stroke fed the way MotionController::runSteps() feeds it must arrive intact.
+#include <unity.h>
+#include "hal/StepGenHal_Mock.h"
+#include "app/controllers/MotionPlanner.h"
+
+static StepGenHal_Mock gen;
+
+void setUp(void) { gen.begin(); }
+void tearDown(void) {}
+
+static void test_gaps_follow_pushed_intervals(void) {
+    static const uint32_t iv[] = { 1000, 800, 650, 500, 500, 650, 800, 1000 };
+    for (uint32_t v : iv) TEST_ASSERT_TRUE(gen.push(v));
+    gen.advanceUs(100000);
+
+    // the last interval is idle time after the final pulse: one pulse per push
+    TEST_ASSERT_EQUAL_UINT32(8, gen.totalEmitted());
+    TEST_ASSERT_EQUAL_UINT16(8, gen.loggedCount());
+    TEST_ASSERT_EQUAL_UINT32(0, gen.loggedGapUs(0));
+    for (uint16_t i = 1; i < 8; i++) TEST_ASSERT_EQUAL_UINT32(iv[i - 1], gen.loggedGapUs(i));
+    TEST_ASSERT_EQUAL_UINT16(0, gen.queued());
+}
+
+static void test_emitted_counts_by_elapsed_time(void) {
+    for (int i = 0; i < 4; i++) gen.push(1000);
+
+    gen.advanceUs(1500);   // pulses at 0 and 1000
+    TEST_ASSERT_EQUAL_UINT32(2, gen.pendingEmitted());
+    TEST_ASSERT_EQUAL_UINT32(2, gen.takeEmitted());
+    TEST_ASSERT_EQUAL_UINT32(0, gen.pendingEmitted());
+    TEST_ASSERT_EQUAL_UINT16(2, gen.queued());
+
+    gen.advanceUs(1500);   // 2000, 3000
+    TEST_ASSERT_EQUAL_UINT32(2, gen.takeEmitted());
+    TEST_ASSERT_EQUAL_UINT16(0, gen.queued());
+}
+
+static void test_underrun_restarts_on_next_push(void) {
+    gen.push(500);
+    gen.advanceUs(2000);   // one pulse at 0, then the queue runs dry
+    TEST_ASSERT_EQUAL_UINT32(1, gen.totalEmitted());
+
+    gen.push(700);
+    gen.push(700);
+    gen.advanceUs(0);      // a refilled queue starts at once, not at a stale deadline
+    TEST_ASSERT_EQUAL_UINT32(2, gen.totalEmitted());
+    TEST_ASSERT_EQUAL_UINT32(2000, gen.loggedGapUs(1));
+
+    gen.advanceUs(700);
+    TEST_ASSERT_EQUAL_UINT32(3, gen.totalEmitted());
+    TEST_ASSERT_EQUAL_UINT32(700, gen.loggedGapUs(2));
+}
+
+static void test_flush_drops_queue_keeps_emitted(void) {
+    for (int i = 0; i < 10; i++) gen.push(1000);
+    gen.advanceUs(2500);   // 0, 1000, 2000
+    gen.flush();
+    TEST_ASSERT_EQUAL_UINT16(0, gen.queued());
+
+    gen.advanceUs(10000);
+    TEST_ASSERT_EQUAL_UINT32(3, gen.takeEmitted());
+    TEST_ASSERT_EQUAL_UINT32(3, gen.totalEmitted());
+}
+
+static void test_planner_stroke_streams_intact(void) {
+    // short trapezoid, fed like runSteps(): top up a few ms of lead every 1 ms "tick"
+    MotionPlanner planner;
+    TEST_ASSERT_TRUE(planner.plan(400, 1200, 3000, 1200, 60000));
+
+    static uint32_t pushed[StepGenHal_Mock::kLogMax];
+    uint16_t nPushed = 0;
+    for (uint32_t tick = 0; tick < 2000 && gen.totalEmitted() < 400; tick++) {
+        while (!planner.done() && gen.queued() < 8 && gen.freeSlots() > 0) {
+            const uint32_t us = planner.nextIntervalUs();
+            if (nPushed < StepGenHal_Mock::kLogMax) pushed[nPushed++] = us;
+            TEST_ASSERT_TRUE(gen.push(us));
+        }
+        gen.advanceUs(1000);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(400, gen.totalEmitted());
+    TEST_ASSERT_EQUAL_UINT16(400, nPushed);
+    for (uint16_t i = 1; i < gen.loggedCount(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(pushed[i - 1], gen.loggedGapUs(i));
+    }
+
+    // never faster than cruise, and the stroke ends back at vEnd
+    uint32_t minGap = 0xFFFFFFFFu;
+    for (uint16_t i = 1; i < gen.loggedCount(); i++) {
+        if (gen.loggedGapUs(i) < minGap) minGap = gen.loggedGapUs(i);
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(1000000u / 3000u, minGap);
+    TEST_ASSERT_UINT32_WITHIN(1000000u / 1200u / 20u, 1000000u / 1200u, pushed[nPushed - 1]);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_gaps_follow_pushed_intervals);
+    RUN_TEST(test_emitted_counts_by_elapsed_time);
+    RUN_TEST(test_underrun_restarts_on_next_push);
+    RUN_TEST(test_flush_drops_queue_keeps_emitted);
+    RUN_TEST(test_planner_stroke_streams_intact);
+    return UNITY_END();
+}